@@ -0,0 +1,1078 @@
+#include <benchmark/benchmark.h>
+#include "core/orderbook.hpp"
+#include "core/matching_engine.hpp"
+#include "utils/flat_id_map.hpp"
+#include <vector>
+#include <random>
+#include <unordered_map>
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace micromatch;
+
+namespace
+{
+    core::Order make_order(uint64_t id, core::Side side, int64_t price, uint32_t quantity)
+    {
+        core::Order order(id, 1, price, quantity, side);
+        return order;
+    }
+
+    core::OrderBookConfig config_for(int64_t storage)
+    {
+        core::OrderBookConfig config;
+        config.level_storage = static_cast<core::PriceLevelStorage>(storage);
+        config.tick_size = 1;
+        config.ladder_levels = 4096;
+        config.reference_price = 10000;
+        return config;
+    }
+
+    const char *storage_label(int64_t storage)
+    {
+        return static_cast<core::PriceLevelStorage>(storage) == core::PriceLevelStorage::LADDER
+                   ? "ladder"
+                   : "map";
+    }
+}
+
+// Cancel latency at a single price level as the level depth grows.
+// Each iteration cancels the oldest resting order and re-adds one at the
+// back so the depth stays constant for the whole run.
+static void BM_CancelAtLevelDepth(benchmark::State &state)
+{
+    const auto depth = static_cast<uint64_t>(state.range(0));
+    auto book = core::create_order_book(1);
+
+    uint64_t next_id = 1;
+    for (uint64_t i = 0; i < depth; ++i)
+    {
+        benchmark::DoNotOptimize(book->add_order(make_order(next_id++, core::Side::BUY, 10000, 100)));
+    }
+
+    uint64_t oldest_id = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book->cancel_order(oldest_id++));
+
+        state.PauseTiming();
+        benchmark::DoNotOptimize(book->add_order(make_order(next_id++, core::Side::BUY, 10000, 100)));
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["depth"] = static_cast<double>(depth);
+}
+
+BENCHMARK(BM_CancelAtLevelDepth)->RangeMultiplier(4)->Range(16, 16384);
+
+// Near-touch churn on a tight tick grid: each iteration adds one passive
+// order a few ticks from the touch and cancels a random older one, so
+// levels are constantly created and emptied around the best price.
+static void BM_NearTouchChurn(benchmark::State &state)
+{
+    const int64_t storage = state.range(0);
+    auto book = core::create_order_book(1, config_for(storage));
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int64_t> tick_dist(1, 16);
+    std::vector<uint64_t> live;
+    live.reserve(1024);
+
+    uint64_t next_id = 1;
+    auto add_one = [&]()
+    {
+        const bool buy = (next_id & 1) == 0;
+        const int64_t price = buy ? 10000 - tick_dist(rng) : 10000 + tick_dist(rng);
+        benchmark::DoNotOptimize(book->add_order(
+            make_order(next_id, buy ? core::Side::BUY : core::Side::SELL, price, 100)));
+        live.push_back(next_id++);
+    };
+
+    for (int i = 0; i < 256; ++i)
+    {
+        add_one();
+    }
+
+    for (auto _ : state)
+    {
+        add_one();
+
+        std::uniform_int_distribution<size_t> pick(0, live.size() - 1);
+        const size_t idx = pick(rng);
+        benchmark::DoNotOptimize(book->cancel_order(live[idx]));
+        live[idx] = live.back();
+        live.pop_back();
+
+        benchmark::DoNotOptimize(book->best_bid());
+        benchmark::DoNotOptimize(book->best_ask());
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+    state.SetLabel(storage_label(storage));
+}
+
+// Sweep an aggressive order through a thin book: resting orders sit every
+// `gap` ticks, so each emptied level forces a search for the next populated
+// one across a run of empty ticks.
+static void BM_ThinBookSweep(benchmark::State &state)
+{
+    const int64_t storage = state.range(0);
+    const int64_t gap = state.range(1);
+    constexpr int64_t levels = 512;
+
+    auto config = config_for(storage);
+    config.ladder_levels = 65536;
+    config.reference_price = 10000 + (levels * gap) / 2;
+
+    auto book = core::create_order_book(1, config);
+    uint64_t next_id = 1;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (int64_t i = 0; i < levels; ++i)
+        {
+            benchmark::DoNotOptimize(book->add_order(
+                make_order(next_id++, core::Side::SELL, 10000 + i * gap, 10)));
+        }
+        state.ResumeTiming();
+
+        auto trades = book->add_order(
+            make_order(next_id++, core::Side::BUY, 10000 + levels * gap, levels * 10));
+        benchmark::DoNotOptimize(trades);
+    }
+
+    state.SetItemsProcessed(state.iterations() * levels);
+    state.SetLabel(storage_label(storage));
+}
+
+BENCHMARK(BM_ThinBookSweep)
+    ->ArgsProduct({{static_cast<int64_t>(core::PriceLevelStorage::MAP),
+                    static_cast<int64_t>(core::PriceLevelStorage::LADDER)},
+                   {1, 16, 100}});
+
+// Order id index at exchange scale: N resting ids, each iteration looks up a
+// random live id (the cancel/modify path) then erases it and inserts a fresh
+// one (a fill plus a new order), so the table stays at N entries.
+namespace
+{
+    struct StdIdIndex
+    {
+        std::unordered_map<uint64_t, uint32_t> map;
+
+        explicit StdIdIndex(size_t n) { map.reserve(n); }
+        void insert(uint64_t key, uint32_t value) { map.emplace(key, value); }
+        const uint32_t *find(uint64_t key) const
+        {
+            auto it = map.find(key);
+            return it != map.end() ? &it->second : nullptr;
+        }
+        void erase(uint64_t key) { map.erase(key); }
+    };
+
+    struct FlatIdIndex
+    {
+        utils::FlatIdMap<uint32_t> map;
+
+        explicit FlatIdIndex(size_t n) : map(n) {}
+        void insert(uint64_t key, uint32_t value) { map.insert(key, value); }
+        const uint32_t *find(uint64_t key) const { return map.find(key); }
+        void erase(uint64_t key) { map.erase(key); }
+    };
+}
+
+template <typename Index>
+static void BM_OrderIdIndex(benchmark::State &state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    Index index(n);
+
+    std::vector<uint64_t> live(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        live[i] = i + 1;
+    }
+    std::mt19937_64 rng(42);
+    std::shuffle(live.begin(), live.end(), rng);
+    for (size_t i = 0; i < n; ++i)
+    {
+        index.insert(live[i], static_cast<uint32_t>(i));
+    }
+
+    uint64_t next_id = n + 1;
+    size_t cursor = 0;
+    for (auto _ : state)
+    {
+        const uint64_t id = live[cursor];
+        benchmark::DoNotOptimize(index.find(id));
+        index.erase(id);
+        index.insert(next_id, static_cast<uint32_t>(cursor));
+        live[cursor] = next_id++;
+        cursor = (cursor + 7919) % n;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_OrderIdIndex, StdIdIndex)->Arg(1 << 20)->Arg(4 << 20);
+BENCHMARK_TEMPLATE(BM_OrderIdIndex, FlatIdIndex)->Arg(1 << 20)->Arg(4 << 20);
+
+BENCHMARK(BM_NearTouchChurn)
+    ->Arg(static_cast<int64_t>(core::PriceLevelStorage::MAP))
+    ->Arg(static_cast<int64_t>(core::PriceLevelStorage::LADDER));
+
+// Fill-or-kill rejection against a deep book: the order asks for one more
+// than the whole opposite side holds, so the feasibility pre-scan walks
+// every level and the book is left untouched each iteration.
+static void BM_FokRejectDeepBook(benchmark::State &state)
+{
+    const int64_t storage = state.range(0);
+    const int64_t levels = state.range(1);
+    constexpr int64_t orders_per_level = 4;
+
+    auto config = config_for(storage);
+    config.ladder_levels = 8192;
+    config.reference_price = 10000 + levels / 2;
+
+    auto book = core::create_order_book(1, config);
+    uint64_t next_id = 1;
+    for (int64_t i = 0; i < levels; ++i)
+    {
+        for (int64_t j = 0; j < orders_per_level; ++j)
+        {
+            benchmark::DoNotOptimize(book->add_order(
+                make_order(next_id++, core::Side::SELL, 10000 + i, 10)));
+        }
+    }
+
+    auto order = make_order(next_id++, core::Side::BUY, 10000 + levels,
+                            static_cast<uint32_t>(levels * orders_per_level * 10 + 1));
+    order.tif = core::TimeInForce::FOK;
+
+    std::vector<core::Trade> trades;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(book->add_order(order, trades));
+    }
+
+    state.SetItemsProcessed(state.iterations() * levels);
+    state.SetLabel(storage_label(storage));
+}
+
+BENCHMARK(BM_FokRejectDeepBook)
+    ->ArgsProduct({{static_cast<int64_t>(core::PriceLevelStorage::MAP),
+                    static_cast<int64_t>(core::PriceLevelStorage::LADDER)},
+                   {64, 1024, 4096}});
+
+// Trade cost with a large population of untriggered stops parked away from
+// the market. Only the front of each stop side is inspected after a trade,
+// so the cost should not grow with the number of stops.
+static void BM_TradeWithParkedStops(benchmark::State &state)
+{
+    const auto stops = static_cast<uint64_t>(state.range(0));
+    auto book = core::create_order_book(1);
+
+    uint64_t next_id = 1;
+    for (uint64_t i = 0; i < stops; ++i)
+    {
+        const bool buy = (i % 2) == 0;
+        auto stop = make_order(next_id++, buy ? core::Side::BUY : core::Side::SELL, 0, 10);
+        stop.type = core::OrderType::STOP;
+        stop.stop_price = buy ? 20000 + static_cast<int64_t>(i) : 5000 - static_cast<int64_t>(i % 4000);
+        benchmark::DoNotOptimize(book->add_order(stop));
+    }
+
+    std::vector<core::Trade> trades;
+    for (auto _ : state)
+    {
+        trades.clear();
+        book->add_order(make_order(next_id++, core::Side::SELL, 10000, 10), trades);
+        book->add_order(make_order(next_id++, core::Side::BUY, 10000, 10), trades);
+        benchmark::DoNotOptimize(trades.data());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["stops"] = static_cast<double>(stops);
+}
+
+BENCHMARK(BM_TradeWithParkedStops)->RangeMultiplier(8)->Range(8, 32768);
+
+// Market-data depth poll after a single level change. The top-N cache is
+// patched in place, so a poll is a fixed-size copy regardless of how many
+// levels the book holds.
+static void BM_DepthPoll(benchmark::State &state)
+{
+    const int64_t storage = state.range(0);
+    const int64_t levels = state.range(1);
+
+    auto config = config_for(storage);
+    config.reference_price = 10000;
+    auto book = core::create_order_book(1, config);
+
+    uint64_t next_id = 1;
+    for (int64_t i = 1; i <= levels; ++i)
+    {
+        benchmark::DoNotOptimize(book->add_order(make_order(next_id++, core::Side::BUY, 10000 - i, 10)));
+        benchmark::DoNotOptimize(book->add_order(make_order(next_id++, core::Side::SELL, 10000 + i, 10)));
+    }
+
+    std::vector<core::Trade> trades;
+    for (auto _ : state)
+    {
+        // Add and remove a bid inside the touch, then poll
+        const uint64_t id = next_id++;
+        book->add_order(make_order(id, core::Side::BUY, 9999, 5), trades);
+        benchmark::DoNotOptimize(book->cancel_order(id));
+        auto depth = book->depth();
+        benchmark::DoNotOptimize(depth);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(storage_label(storage));
+}
+
+BENCHMARK(BM_DepthPoll)
+    ->ArgsProduct({{static_cast<int64_t>(core::PriceLevelStorage::MAP),
+                    static_cast<int64_t>(core::PriceLevelStorage::LADDER)},
+                   {16, 1024}});
+
+// Sweep one aggressive order through a single deep level, rebuilt outside
+// the timed region each iteration. The matcher walks the level's FIFO, so
+// the cost is dominated by how many bytes each resting order occupies.
+static void BM_DeepLevelSweep(benchmark::State &state)
+{
+    const auto depth = static_cast<uint32_t>(state.range(0));
+    core::OrderBookConfig config;
+    config.initial_order_capacity = depth + 1024;
+    auto book = core::create_order_book(1, config);
+
+    std::vector<core::Trade> trades;
+    trades.reserve(depth);
+    uint64_t next_id = 1;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (uint32_t i = 0; i < depth; ++i)
+        {
+            benchmark::DoNotOptimize(book->add_order(make_order(next_id++, core::Side::SELL, 10000, 10)));
+        }
+        trades.clear();
+        state.ResumeTiming();
+
+        book->add_order(make_order(next_id++, core::Side::BUY, 10000, depth * 10), trades);
+        benchmark::DoNotOptimize(trades.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+
+BENCHMARK(BM_DeepLevelSweep)->RangeMultiplier(8)->Range(1024, 65536);
+
+// Closing auction across many symbols: each book collects a crossed set of
+// orders over `levels` prices per side, then every book is uncrossed. The
+// timed region is the uncross alone, reported per symbol.
+static void BM_ClosingAuction(benchmark::State &state)
+{
+    const int64_t symbols = state.range(0);
+    const int64_t levels = state.range(1);
+
+    // Size each book for its auction rather than a full session
+    core::OrderBookConfig config;
+    config.initial_order_capacity = static_cast<size_t>(levels) * 2;
+
+    std::vector<std::unique_ptr<core::IOrderBook>> books;
+    for (int64_t s = 0; s < symbols; ++s)
+    {
+        books.push_back(core::create_order_book(static_cast<uint64_t>(s), config));
+    }
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<uint32_t> qty_dist(1, 100);
+    std::vector<core::Trade> trades;
+    uint64_t next_id = 1;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (auto &book : books)
+        {
+            book->clear();
+            book->begin_auction();
+            for (int64_t i = 0; i < levels; ++i)
+            {
+                // Bids and asks span the same prices, so the whole book crosses
+                book->add_order(make_order(next_id++, core::Side::BUY, 10000 + levels / 2 - i, qty_dist(rng)), trades);
+                book->add_order(make_order(next_id++, core::Side::SELL, 10000 - levels / 2 + i, qty_dist(rng)), trades);
+            }
+        }
+        trades.clear();
+        state.ResumeTiming();
+
+        for (auto &book : books)
+        {
+            benchmark::DoNotOptimize(book->uncross(trades, 10000));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * symbols);
+    state.counters["trades"] = static_cast<double>(trades.size()) / static_cast<double>(symbols);
+}
+
+BENCHMARK(BM_ClosingAuction)->ArgsProduct({{1, 1000, 4000}, {16, 128}})->Unit(benchmark::kMicrosecond);
+
+// End-to-end engine throughput under one fixed order flow: continuous
+// matching against frequent batch auctions clearing every 100us. Each
+// iteration submits the whole flow to a fresh engine and waits until the
+// worker has applied every order.
+static void BM_EngineModeThroughput(benchmark::State &state)
+{
+    const auto mode = static_cast<core::MatchingMode>(state.range(0));
+    constexpr size_t ORDERS = 200000;
+    constexpr uint64_t SYMBOLS = 16;
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int64_t> price_dist(9990, 10010);
+    std::uniform_int_distribution<uint32_t> qty_dist(1, 100);
+    std::vector<core::Order> flow;
+    flow.reserve(ORDERS);
+    for (size_t i = 0; i < ORDERS; ++i)
+    {
+        const auto side = (rng() & 1) ? core::Side::BUY : core::Side::SELL;
+        flow.emplace_back(i + 1, i % SYMBOLS, price_dist(rng), qty_dist(rng), side);
+    }
+
+    core::MatchingEngineConfig config;
+    config.mode = mode;
+    config.batch_interval = std::chrono::microseconds(100);
+
+    uint64_t trades = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto engine = core::create_matching_engine(config);
+        for (uint64_t s = 0; s < SYMBOLS; ++s)
+        {
+            engine->register_symbol(s);
+        }
+        engine->start();
+        state.ResumeTiming();
+
+        for (const auto &order : flow)
+        {
+            engine->submit_order(order);
+        }
+        while (engine->get_stats().total_orders < ORDERS)
+        {
+            std::this_thread::yield();
+        }
+
+        state.PauseTiming();
+        engine->stop();
+        trades = engine->get_stats().total_trades;
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ORDERS);
+    state.counters["trades"] = static_cast<double>(trades);
+    state.SetLabel(mode == core::MatchingMode::BATCH_AUCTION ? "batch" : "continuous");
+}
+
+BENCHMARK(BM_EngineModeThroughput)
+    ->Arg(static_cast<int64_t>(core::MatchingMode::CONTINUOUS))
+    ->Arg(static_cast<int64_t>(core::MatchingMode::BATCH_AUCTION))
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Matching throughput with the request journal off (arg 0) or on under
+// each durability policy (arg 1 + DurabilityPolicy). Timing stops once the
+// worker has applied every order; the journal thread may still be writing,
+// and how long it then takes to make everything durable is reported as
+// drain_ms.
+static void BM_JournalOverhead(benchmark::State &state)
+{
+    constexpr size_t ORDERS = 50000;
+    constexpr uint64_t SYMBOLS = 16;
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "micromatch_bench_journal.bin").string();
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int64_t> price_dist(9990, 10010);
+    std::uniform_int_distribution<uint32_t> qty_dist(1, 100);
+    std::vector<core::Order> flow;
+    flow.reserve(ORDERS);
+    for (size_t i = 0; i < ORDERS; ++i)
+    {
+        const auto side = (rng() & 1) ? core::Side::BUY : core::Side::SELL;
+        flow.emplace_back(i + 1, i % SYMBOLS, price_dist(rng), qty_dist(rng), side);
+    }
+
+    core::MatchingEngineConfig config;
+    if (state.range(0) > 0)
+    {
+        config.journal = core::JournalConfig{path, static_cast<core::DurabilityPolicy>(state.range(0) - 1)};
+    }
+
+    double drain_ms = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::filesystem::remove(path);
+        auto engine = core::create_matching_engine(config);
+        for (uint64_t s = 0; s < SYMBOLS; ++s)
+        {
+            engine->register_symbol(s);
+        }
+        engine->start();
+        state.ResumeTiming();
+
+        for (const auto &order : flow)
+        {
+            engine->submit_order(order);
+        }
+        while (engine->get_stats().total_orders < ORDERS)
+        {
+            std::this_thread::yield();
+        }
+
+        state.PauseTiming();
+        const auto drain_start = std::chrono::steady_clock::now();
+        engine->stop();
+        drain_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - drain_start).count();
+        state.ResumeTiming();
+    }
+    std::filesystem::remove(path);
+
+    static const char *const LABELS[] = {"no journal", "async", "per batch", "per message"};
+    state.SetItemsProcessed(state.iterations() * ORDERS);
+    state.counters["drain_ms"] = drain_ms / static_cast<double>(state.iterations());
+    state.SetLabel(LABELS[state.range(0)]);
+}
+
+BENCHMARK(BM_JournalOverhead)
+    ->DenseRange(0, 3)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Recovery speed: the same 200k-order flow over 16 symbols matched live
+// through the worker (arg 0), against replaying its journal into fresh
+// books book by book (arg 1) or in journal order with callbacks (arg 2).
+// The journal is recorded once, untimed.
+static void BM_JournalReplay(benchmark::State &state)
+{
+    constexpr size_t ORDERS = 200000;
+    constexpr uint64_t SYMBOLS = 16;
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "micromatch_bench_replay.bin").string();
+
+    std::mt19937 rng(13);
+    std::uniform_int_distribution<int64_t> price_dist(9990, 10010);
+    std::uniform_int_distribution<uint32_t> qty_dist(1, 100);
+    std::vector<core::Order> flow;
+    flow.reserve(ORDERS);
+    for (size_t i = 0; i < ORDERS; ++i)
+    {
+        const auto side = (rng() & 1) ? core::Side::BUY : core::Side::SELL;
+        flow.emplace_back(i + 1, i % SYMBOLS, price_dist(rng), qty_dist(rng), side);
+    }
+
+    auto run_live = [&](const core::MatchingEngineConfig &config)
+    {
+        auto engine = core::create_matching_engine(config);
+        for (uint64_t s = 0; s < SYMBOLS; ++s)
+        {
+            engine->register_symbol(s);
+        }
+        engine->set_trade_callback([](const core::Trade &trade)
+                                   { benchmark::DoNotOptimize(trade.trade_id); });
+        engine->start();
+        for (const auto &order : flow)
+        {
+            engine->submit_order(order);
+        }
+        while (engine->get_stats().total_orders < ORDERS)
+        {
+            std::this_thread::yield();
+        }
+        engine->stop();
+    };
+
+    std::filesystem::remove(path);
+    core::MatchingEngineConfig journaled;
+    journaled.journal = core::JournalConfig{path, core::DurabilityPolicy::ASYNC};
+    run_live(journaled);
+
+    core::ReplayOptions options;
+    options.publish = state.range(0) == 2;
+    for (auto _ : state)
+    {
+        if (state.range(0) == 0)
+        {
+            run_live(core::MatchingEngineConfig{});
+            continue;
+        }
+
+        state.PauseTiming();
+        auto engine = core::create_matching_engine();
+        for (uint64_t s = 0; s < SYMBOLS; ++s)
+        {
+            engine->register_symbol(s);
+        }
+        engine->set_trade_callback([](const core::Trade &trade)
+                                   { benchmark::DoNotOptimize(trade.trade_id); });
+        state.ResumeTiming();
+
+        if (!engine->replay_journal(path, options))
+        {
+            state.SkipWithError("replay failed");
+            break;
+        }
+    }
+    std::filesystem::remove(path);
+
+    static const char *const LABELS[] = {"live", "replay by book", "replay in order"};
+    state.SetItemsProcessed(state.iterations() * ORDERS);
+    state.SetLabel(LABELS[state.range(0)]);
+}
+
+BENCHMARK(BM_JournalReplay)
+    ->DenseRange(0, 2)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Tick-to-ack latency per worker wait strategy (arg = WaitStrategy): an
+// order is submitted after a 200µs lull and timed until the worker's
+// accept callback fires, so every sample includes the worker waking up.
+// Iteration time is the latency itself; p50 / p99 are in the counters.
+static void BM_TickToAck(benchmark::State &state)
+{
+    core::MatchingEngineConfig config;
+    config.wait_strategy = static_cast<utils::WaitStrategy>(state.range(0));
+    auto engine = core::create_matching_engine(config);
+    engine->register_symbol(1);
+    std::atomic<uint64_t> acked{0};
+    engine->set_order_callback([&](const core::Order &, bool)
+                               { acked.fetch_add(1, std::memory_order_release); });
+    engine->start();
+
+    std::vector<double> samples;
+    uint64_t next_id = 1;
+    for (auto _ : state)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        // Alternate sides at one price so the book stays small
+        const auto side = (next_id & 1) ? core::Side::BUY : core::Side::SELL;
+        const auto order = make_order(next_id++, side, 10000, 10);
+
+        const uint64_t target = acked.load(std::memory_order_relaxed) + 1;
+        const auto start = std::chrono::steady_clock::now();
+        engine->submit_order(order);
+        while (acked.load(std::memory_order_acquire) < target)
+        {
+            std::this_thread::yield();
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        state.SetIterationTime(elapsed);
+        samples.push_back(elapsed * 1e9);
+    }
+    engine->stop();
+
+    std::sort(samples.begin(), samples.end());
+    static const char *const LABELS[] = {"sleep", "busy spin", "spin-yield", "spin-park"};
+    state.counters["p50_ns"] = samples[samples.size() / 2];
+    state.counters["p99_ns"] = samples[samples.size() * 99 / 100];
+    state.SetLabel(LABELS[state.range(0)]);
+}
+
+BENCHMARK(BM_TickToAck)
+    ->DenseRange(0, 3)
+    ->Iterations(2000)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
+// Engine throughput against worker count (arg = shards): 400k orders over
+// 8000 symbols fed by one producer, timed until every shard has applied
+// its share. Books are registered and the flow built untimed.
+static void BM_ShardScaling(benchmark::State &state)
+{
+    constexpr size_t ORDERS = 400000;
+    constexpr uint64_t SYMBOLS = 8000;
+
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int64_t> price_dist(9990, 10010);
+    std::uniform_int_distribution<uint32_t> qty_dist(1, 100);
+    std::uniform_int_distribution<uint64_t> symbol_dist(0, SYMBOLS - 1);
+    std::vector<core::Order> flow;
+    flow.reserve(ORDERS);
+    for (size_t i = 0; i < ORDERS; ++i)
+    {
+        const auto side = (rng() & 1) ? core::Side::BUY : core::Side::SELL;
+        flow.emplace_back(i + 1, symbol_dist(rng), price_dist(rng), qty_dist(rng), side);
+    }
+
+    core::MatchingEngineConfig config;
+    config.shards = static_cast<size_t>(state.range(0));
+    config.wait_strategy = utils::WaitStrategy::SPIN_PARK;
+    config.book_config.initial_order_capacity = 256;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto engine = core::create_matching_engine(config);
+        for (uint64_t s = 0; s < SYMBOLS; ++s)
+        {
+            engine->register_symbol(s);
+        }
+        engine->start();
+        state.ResumeTiming();
+
+        for (const auto &order : flow)
+        {
+            engine->submit_order(order);
+        }
+        while (engine->get_stats().total_orders < ORDERS)
+        {
+            std::this_thread::yield();
+        }
+
+        state.PauseTiming();
+        engine->stop();
+        engine.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ORDERS);
+    state.counters["cpus"] = std::thread::hardware_concurrency();
+}
+
+BENCHMARK(BM_ShardScaling)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Several threads submitting to one engine at once, each through its own
+// ingress ring. Total flow is fixed; the argument is the number of
+// producer threads splitting it.
+static void BM_IngressProducers(benchmark::State &state)
+{
+    constexpr size_t ORDERS = 200000;
+    constexpr uint64_t SYMBOLS = 16;
+    const auto producers = static_cast<size_t>(state.range(0));
+
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<int64_t> price_dist(9990, 10010);
+    std::uniform_int_distribution<uint32_t> qty_dist(1, 100);
+    std::vector<core::Order> flow;
+    flow.reserve(ORDERS);
+    for (size_t i = 0; i < ORDERS; ++i)
+    {
+        const auto side = (rng() & 1) ? core::Side::BUY : core::Side::SELL;
+        flow.emplace_back(i + 1, i % SYMBOLS, price_dist(rng), qty_dist(rng), side);
+    }
+
+    core::MatchingEngineConfig config;
+    config.wait_strategy = utils::WaitStrategy::SPIN_PARK;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto engine = core::create_matching_engine(config);
+        for (uint64_t s = 0; s < SYMBOLS; ++s)
+        {
+            engine->register_symbol(s);
+        }
+        engine->start();
+        state.ResumeTiming();
+
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p]
+                                 {
+                for (size_t i = p; i < ORDERS; i += producers)
+                {
+                    engine->submit_order(flow[i]);
+                } });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        while (engine->get_stats().total_orders < ORDERS)
+        {
+            std::this_thread::yield();
+        }
+
+        state.PauseTiming();
+        engine->stop();
+        engine.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ORDERS);
+    state.counters["cpus"] = std::thread::hardware_concurrency();
+}
+
+BENCHMARK(BM_IngressProducers)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Kill switch for one client holding 50k of 100k resting orders spread
+// over 1000 levels: a single mass_cancel walking the client's list against
+// one cancel_order per order. The book is rebuilt untimed each iteration.
+static void BM_ClientKillSwitch(benchmark::State &state)
+{
+    const bool mass = state.range(0) != 0;
+    constexpr uint32_t ORDERS = 100000;
+    constexpr uint64_t CLIENT = 7;
+
+    core::OrderBookConfig config;
+    config.initial_order_capacity = ORDERS;
+    auto book = core::create_order_book(1, config);
+
+    std::vector<uint64_t> client_ids;
+    client_ids.reserve(ORDERS / 2);
+    uint64_t next_id = 1;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        book->clear();
+        client_ids.clear();
+        for (uint32_t i = 0; i < ORDERS; ++i)
+        {
+            auto order = make_order(next_id++, core::Side::BUY, 10000 - (i % 1000), 10);
+            order.client_id = (i % 2) ? CLIENT : 100 + (i % 64);
+            if (order.client_id == CLIENT)
+            {
+                client_ids.push_back(order.order_id);
+            }
+            benchmark::DoNotOptimize(book->add_order(order));
+        }
+        state.ResumeTiming();
+
+        if (mass)
+        {
+            benchmark::DoNotOptimize(book->mass_cancel(CLIENT));
+        }
+        else
+        {
+            for (uint64_t id : client_ids)
+            {
+                benchmark::DoNotOptimize(book->cancel_order(id));
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * ORDERS / 2);
+    state.SetLabel(mass ? "mass_cancel" : "cancel_order");
+}
+
+BENCHMARK(BM_ClientKillSwitch)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+// Restart cost for an engine holding range(1) resting orders over 8 books:
+// replaying each order through add_order (arg 0) against restoring a
+// checkpoint file through mmap (arg 1). The replay is a lower bound, as it
+// feeds only the surviving orders and none of the history behind them.
+static void BM_RestartFromCheckpoint(benchmark::State &state)
+{
+    const bool restore = state.range(0) != 0;
+    const auto orders = static_cast<size_t>(state.range(1));
+    constexpr uint64_t SYMBOLS = 8;
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "micromatch_bench_checkpoint.bin").string();
+
+    // Bids below 10000 and asks above it over 500 levels a side, so
+    // nothing trades and every order rests
+    std::vector<core::Order> flow;
+    flow.reserve(orders);
+    for (size_t i = 0; i < orders; ++i)
+    {
+        const auto side = (i & 1) ? core::Side::SELL : core::Side::BUY;
+        const auto offset = static_cast<int64_t>(1 + (i / 2) % 500);
+        const int64_t price = (side == core::Side::BUY) ? 10000 - offset : 10000 + offset;
+        flow.emplace_back(i + 1, 1 + i % SYMBOLS, price, 10, side, 1 + i % 64);
+    }
+
+    auto register_all = [](core::IMatchingEngine &engine)
+    {
+        for (uint64_t s = 1; s <= SYMBOLS; ++s)
+        {
+            engine.register_symbol(s);
+        }
+    };
+    std::vector<core::Trade> trades;
+    auto replay = [&](core::IMatchingEngine &engine)
+    {
+        for (const auto &order : flow)
+        {
+            engine.get_order_book(order.symbol_id)->add_order(order, trades);
+        }
+    };
+
+    if (restore)
+    {
+        auto source = core::create_matching_engine();
+        register_all(*source);
+        replay(*source);
+        if (!source->save_checkpoint(path))
+        {
+            state.SkipWithError("could not write checkpoint");
+            return;
+        }
+        state.counters["file_MB"] = static_cast<double>(std::filesystem::file_size(path)) / 1e6;
+    }
+
+    for (auto _ : state)
+    {
+        auto engine = core::create_matching_engine();
+        if (restore)
+        {
+            benchmark::DoNotOptimize(engine->restore_checkpoint(path));
+        }
+        else
+        {
+            register_all(*engine);
+            replay(*engine);
+        }
+
+        state.PauseTiming();
+        engine.reset();
+        state.ResumeTiming();
+    }
+
+    if (restore)
+    {
+        std::filesystem::remove(path);
+    }
+    state.SetItemsProcessed(state.iterations() * orders);
+    state.SetLabel(restore ? "mmap restore" : "replay");
+}
+
+BENCHMARK(BM_RestartFromCheckpoint)
+    ->Args({0, 1 << 20})
+    ->Args({1, 1 << 20})
+    ->Args({0, 4 << 20})
+    ->Args({1, 4 << 20})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Hardware instruction counter for this thread (user space only). Reports
+// nothing where perf events are unavailable, e.g. in restricted containers.
+namespace
+{
+    class InstructionCounter
+    {
+    private:
+        int fd_{-1};
+
+    public:
+        InstructionCounter()
+        {
+#ifdef __linux__
+            perf_event_attr attr{};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+
+        ~InstructionCounter()
+        {
+#ifdef __linux__
+            if (fd_ >= 0)
+            {
+                close(fd_);
+            }
+#endif
+        }
+
+        bool available() const { return fd_ >= 0; }
+
+        void start()
+        {
+#ifdef __linux__
+            if (fd_ >= 0)
+            {
+                ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        uint64_t stop()
+        {
+            uint64_t count = 0;
+#ifdef __linux__
+            if (fd_ >= 0)
+            {
+                ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+                if (read(fd_, &count, sizeof(count)) != sizeof(count))
+                {
+                    count = 0;
+                }
+            }
+#endif
+            return count;
+        }
+    };
+}
+
+// Cost of a single-fill match, alternating buy and sell aggressors so both
+// sides of the matcher are exercised. Each iteration rests one order and
+// crosses it with one order of the opposite side.
+static void BM_SingleFillMatch(benchmark::State &state)
+{
+    const int64_t storage = state.range(0);
+    auto book = core::create_order_book(1, config_for(storage));
+
+    // Background liquidity away from the touch
+    uint64_t next_id = 1;
+    for (int64_t i = 1; i <= 64; ++i)
+    {
+        benchmark::DoNotOptimize(book->add_order(make_order(next_id++, core::Side::BUY, 9900 - i, 10)));
+        benchmark::DoNotOptimize(book->add_order(make_order(next_id++, core::Side::SELL, 10100 + i, 10)));
+    }
+
+    std::vector<core::Trade> trades;
+    trades.reserve(16);
+    InstructionCounter counter;
+    counter.start();
+    for (auto _ : state)
+    {
+        const bool buy = (next_id & 2) != 0;
+        const auto passive = buy ? core::Side::SELL : core::Side::BUY;
+        const auto aggressive = buy ? core::Side::BUY : core::Side::SELL;
+
+        trades.clear();
+        book->add_order(make_order(next_id++, passive, 10000, 10), trades);
+        book->add_order(make_order(next_id++, aggressive, 10000, 10), trades);
+        benchmark::DoNotOptimize(trades.data());
+    }
+    const uint64_t instructions = counter.stop();
+
+    state.SetItemsProcessed(state.iterations());
+    if (counter.available() && state.iterations() > 0)
+    {
+        state.counters["instructions/match"] =
+            static_cast<double>(instructions) / static_cast<double>(state.iterations());
+    }
+    state.SetLabel(storage_label(storage));
+}
+
+BENCHMARK(BM_SingleFillMatch)
+    ->Arg(static_cast<int64_t>(core::PriceLevelStorage::MAP))
+    ->Arg(static_cast<int64_t>(core::PriceLevelStorage::LADDER));
+
+BENCHMARK_MAIN();
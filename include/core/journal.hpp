@@ -0,0 +1,169 @@
+#pragma once
+
+#include "order.hpp"
+#include "utils/mapped_file.hpp"
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace micromatch::core
+{
+
+    // What a journal record describes
+    enum class JournalEntry : uint8_t
+    {
+        NEW_ORDER = 0,
+        CANCEL_ORDER = 1,
+        MODIFY_ORDER = 2,
+        MASS_CANCEL = 3,
+        EXPIRE = 4,      // GTD sweep that expired orders, at timestamp_ns
+        BATCH_CLEAR = 5, // Batch auction interval cleared
+        PURGE_DAY = 6    // End of session: DAY orders dropped from every book
+    };
+
+    // One journaled event, fixed size so the file is a flat array of them
+    // behind a header. Fields not used by an entry type are zero.
+    struct alignas(64) JournalRecord
+    {
+        uint64_t sequence{0};     // 1-based, in the order the worker applied events
+        uint64_t timestamp_ns{0}; // Worker steady clock when the event was applied
+        uint64_t symbol_id{0};
+        uint64_t order_id{0};
+        uint64_t client_id{0};
+        int64_t new_price{0};
+        uint32_t new_quantity{0};
+        JournalEntry entry{JournalEntry::NEW_ORDER};
+        uint8_t has_side{0};
+        Side side{Side::BUY};
+        uint8_t reserved{0};
+        Order order; // NEW_ORDER only
+    };
+
+    static_assert(sizeof(JournalRecord) == 128, "Journal record size is part of the file format");
+
+    // First record-sized block of every journal file
+    struct JournalFileHeader
+    {
+        static constexpr uint64_t MAGIC = 0x314C4E524A4D4D4Dull; // "MMMJRNL1"
+
+        uint64_t magic{MAGIC};
+        uint64_t record_size{sizeof(JournalRecord)};
+        uint8_t reserved[sizeof(JournalRecord) - 2 * sizeof(uint64_t)]{};
+    };
+
+    static_assert(sizeof(JournalFileHeader) == sizeof(JournalRecord));
+
+    // When appended records are forced to stable storage
+    enum class DurabilityPolicy : uint8_t
+    {
+        ASYNC = 0,      // Written as they arrive; flushing is left to the OS
+        PER_BATCH = 1,  // One fdatasync per batch written (group commit)
+        PER_MESSAGE = 2 // One write and fdatasync per record
+    };
+
+    // Journal construction parameters
+    struct JournalConfig
+    {
+        std::string path;
+        DurabilityPolicy durability = DurabilityPolicy::PER_BATCH;
+
+        // Records the ring between producer and journal thread can hold
+        // (rounded up to a power of two); further records wait in a
+        // producer-side backlog rather than blocking the producer
+        size_t ring_capacity = size_t{1} << 16;
+
+        // Most records handed to a single write()
+        size_t max_batch = 4096;
+    };
+
+    // Snapshot of journal activity
+    struct JournalStats
+    {
+        uint64_t records{0};    // Records written to the file
+        uint64_t batches{0};    // write() calls
+        uint64_t syncs{0};      // fdatasync() calls
+        uint64_t backlogged{0}; // Appends that found the ring full
+        uint64_t write_errors{0};
+        uint64_t dropped{0}; // Records discarded after a write error
+    };
+
+    // Append-only request journal. append() is called from one producer
+    // thread (the matching worker) and only copies the record into a
+    // lock-free ring; a dedicated thread takes contiguous runs off the ring
+    // and writes each run with a single write(), syncing per the policy.
+    class IJournal
+    {
+    public:
+        virtual ~IJournal() = default;
+
+        // Queue a record; never blocks. If the ring is full the record is
+        // held in a producer-side backlog, which is moved into the ring
+        // ahead of later records.
+        virtual void append(const JournalRecord &record) = 0;
+
+        // Move backlogged records into the ring as space allows; the
+        // producer calls this when idle so a backlog does not linger
+        virtual void drain_backlog() = 0;
+
+        // Block until every appended record is written and synced,
+        // whatever the policy. Producer thread only.
+        virtual void flush() = 0;
+
+        // Highest sequence written and, unless ASYNC, synced. Records reach
+        // the file strictly in order, so everything up to it is there.
+        [[nodiscard]] virtual uint64_t durable_sequence() const = 0;
+
+        // Whether a write or sync has failed. The first failure truncates
+        // any partly written record and latches: later records are
+        // dropped rather than written after a gap, and durable_sequence()
+        // stays at the last record that made it.
+        [[nodiscard]] virtual bool failed() const = 0;
+
+        // Sequence of the last record in the file when it was opened
+        [[nodiscard]] virtual uint64_t last_sequence() const = 0;
+
+        [[nodiscard]] virtual JournalStats stats() const = 0;
+    };
+
+    // Open (creating if needed) a journal for appending, dropping a torn
+    // record at the end of an existing file. Returns nullptr on failure.
+    [[nodiscard]] std::unique_ptr<IJournal> open_journal(const JournalConfig &config);
+
+    // Read-only view of a journal file
+    class JournalReader
+    {
+    private:
+        utils::MappedFile file_;
+        size_t count_{0};
+        bool valid_{false};
+
+    public:
+        explicit JournalReader(const std::string &path) : file_(path)
+        {
+            JournalFileHeader header;
+            if (!file_.is_open() || file_.size() < sizeof(header))
+            {
+                return;
+            }
+            std::memcpy(&header, file_.data(), sizeof(header));
+            valid_ = header.magic == JournalFileHeader::MAGIC &&
+                     header.record_size == sizeof(JournalRecord);
+            if (valid_)
+            {
+                count_ = (file_.size() - sizeof(header)) / sizeof(JournalRecord); // A torn tail is ignored
+            }
+        }
+
+        [[nodiscard]] bool valid() const noexcept { return valid_; }
+        [[nodiscard]] size_t size() const noexcept { return count_; }
+
+        [[nodiscard]] JournalRecord operator[](size_t index) const noexcept
+        {
+            JournalRecord record;
+            std::memcpy(&record, file_.data() + sizeof(JournalFileHeader) + index * sizeof(JournalRecord),
+                        sizeof(record));
+            return record;
+        }
+    };
+
+} // namespace micromatch::core
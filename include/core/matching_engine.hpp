@@ -1,11 +1,16 @@
 #pragma once
 
 #include "orderbook.hpp"
-#include "utils/spsc_queue.hpp"
+#include "journal.hpp"
+#include "utils/spsc_ring.hpp"
+#include "utils/wait_strategy.hpp"
 #include <unordered_map>
 #include <memory>
 #include <functional>
 #include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
 
 namespace micromatch::core
 {
@@ -26,6 +31,8 @@ namespace micromatch::core
         std::atomic<uint64_t> rejected_orders{0};
         std::atomic<uint64_t> cancelled_orders{0};
         std::atomic<uint64_t> modified_orders{0};
+        std::atomic<uint64_t> modified_in_place{0}; // Subset of modified_orders that kept priority
+        std::atomic<uint64_t> expired_orders{0};    // GTD orders removed at their deadline
 
         void reset()
         {
@@ -35,6 +42,8 @@ namespace micromatch::core
             rejected_orders = 0;
             cancelled_orders = 0;
             modified_orders = 0;
+            modified_in_place = 0;
+            expired_orders = 0;
         }
     };
 
@@ -47,14 +56,86 @@ namespace micromatch::core
         uint64_t rejected_orders;
         uint64_t cancelled_orders;
         uint64_t modified_orders;
+        uint64_t modified_in_place;
+        uint64_t expired_orders;
+    };
+
+    // How the engine executes incoming orders
+    enum class MatchingMode : uint8_t
+    {
+        CONTINUOUS = 0,   // Each order matches on arrival
+        BATCH_AUCTION = 1 // Orders collect for an interval, then each book uncrosses at one price
+    };
+
+    // Matching engine construction parameters
+    struct MatchingEngineConfig
+    {
+        MatchingMode mode = MatchingMode::CONTINUOUS;
+
+        // Batch auction mode: how long requests collect before every book
+        // touched in the interval is cleared
+        std::chrono::microseconds batch_interval{100};
+
+        // Journal every request the worker applies (plus GTD expiries and
+        // batch clears) to this file while the engine runs. The worker only
+        // copies each record into a ring; a journal thread does the I/O.
+        std::optional<JournalConfig> journal;
+
+        // How the worker waits for requests when its queue is empty. SLEEP
+        // adds a sleep's wake-up latency to the first order after a lull;
+        // BUSY_SPIN avoids it by dedicating a core to the worker, and
+        // SPIN_PARK spins briefly and then parks until a submit wakes it.
+        utils::WaitStrategy wait_strategy = utils::WaitStrategy::SLEEP;
+
+        // Worker threads. With more than one, symbols are partitioned
+        // across shards by symbol_id, each with its own queue, worker and
+        // books, and requests are routed to their symbol's shard. Callbacks
+        // then run on every shard's worker, concurrently across shards.
+        // Each shard journals to "<journal path>.<shard>", which is where
+        // replay_journal() reads it back; a checkpoint is still one file.
+        size_t shards = 1;
+
+        // Settings for every book the engine creates. With thousands of
+        // mostly thin books, a small initial_order_capacity keeps the
+        // preallocated memory per symbol down; books grow as needed.
+        OrderBookConfig book_config{};
+
+        // Requests each submitting thread can have queued before it waits
+        // for the worker (rounded up to a power of two)
+        size_t ingress_capacity = 4096;
+    };
+
+    // Journal replay parameters
+    struct ReplayOptions
+    {
+        // Skip records up to and including this sequence, e.g. those
+        // already reflected in a checkpoint the books were restored from
+        uint64_t after_sequence = 0;
+
+        // Report orders and trades through the callbacks, in journal order
+        // on the calling thread; replay is then single-threaded
+        bool publish = false;
+
+        // Threads replaying books at once when not publishing
+        // (0 = one per hardware thread)
+        size_t threads = 0;
     };
 
     // Matching engine interface
     class IMatchingEngine
     {
     public:
+        // symbol_id for requests that apply to every registered book
+        static constexpr uint64_t ALL_SYMBOLS = UINT64_MAX;
+
         virtual ~IMatchingEngine() = default;
 
+        // Requests may be submitted from any number of threads at once.
+        // Each thread gets its own ingress ring on its first submit and
+        // hands it back when it exits, so requests
+        // from one thread are applied in the order it made them; requests
+        // from different threads are interleaved.
+
         // Submit a new order
         virtual void submit_order(Order order) = 0;
 
@@ -65,6 +146,13 @@ namespace micromatch::core
         virtual void modify_order(uint64_t symbol_id, uint64_t order_id,
                                   int64_t new_price, uint32_t new_quantity) = 0;
 
+        // Cancel every resting order of `client_id` (0 = every client) in
+        // `symbol_id` (ALL_SYMBOLS = every book), optionally on one side.
+        // With a client id this is a kill switch that walks only that
+        // client's orders.
+        virtual void mass_cancel(uint64_t symbol_id, uint64_t client_id,
+                                 std::optional<Side> side = std::nullopt) = 0;
+
         // Register symbol for trading
         virtual bool register_symbol(uint64_t symbol_id) = 0;
 
@@ -84,6 +172,33 @@ namespace micromatch::core
         // Clear all order books
         virtual void clear_all_books() = 0;
 
+        // End of session: drop DAY orders from every book, keeping GTC / GTD.
+        // While running this is queued and journaled like any other request
+        // (in batch mode it applies at the next clear); otherwise it
+        // applies at once.
+        virtual void purge_day_orders() = 0;
+
+        // Write every book to a checkpoint file at `path`, or replace every
+        // book with those in such a file. The file is a header followed by
+        // each book's flat image; restore maps it and rebuilds each book in
+        // one pass instead of replaying orders. Only valid while stopped.
+        // Returns false on failure, in which case a restore leaves the
+        // current books untouched.
+        virtual bool save_checkpoint(const std::string &path) const = 0;
+        virtual bool restore_checkpoint(const std::string &path) = 0;
+
+        // Re-apply a journal written by an engine in the same mode to the
+        // registered books, which must hold the state the journal started
+        // from (empty, or a checkpoint plus options.after_sequence). Trades
+        // are stamped from the journal, so they match the recorded run
+        // bit for bit, trade ids included. Books are independent, so
+        // without callbacks each book replays its own records on its own
+        // thread, with no queue hop and no sleeps. Requests collected for
+        // a batch that the journal never cleared are dropped, as they were
+        // never applied. Only valid while stopped; returns false if the
+        // journal cannot be read.
+        virtual bool replay_journal(const std::string &path, const ReplayOptions &options = {}) = 0;
+
         // Start/stop the engine
         virtual void start() = 0;
         virtual void stop() = 0;
@@ -92,6 +207,7 @@ namespace micromatch::core
 
     // Factory function to create a matching engine
     [[nodiscard]] std::unique_ptr<IMatchingEngine> create_matching_engine();
+    [[nodiscard]] std::unique_ptr<IMatchingEngine> create_matching_engine(const MatchingEngineConfig &config);
 
     // Order request types for internal processing
     struct OrderRequest
@@ -100,15 +216,19 @@ namespace micromatch::core
         {
             NEW_ORDER,
             CANCEL_ORDER,
-            MODIFY_ORDER
+            MODIFY_ORDER,
+            MASS_CANCEL,
+            PURGE_DAY
         };
 
+        Order order; // First, so its alignment adds no padding
         Type type;
-        Order order;
         uint64_t order_id;
         uint64_t symbol_id;
         int64_t new_price;
         uint32_t new_quantity;
+        uint64_t client_id;
+        std::optional<Side> side;
 
         // Constructors for different request types
         static OrderRequest new_order(Order order)
@@ -139,6 +259,25 @@ namespace micromatch::core
             req.new_quantity = new_quantity;
             return req;
         }
+
+        static OrderRequest mass_cancel(uint64_t symbol_id, uint64_t client_id,
+                                        std::optional<Side> side)
+        {
+            OrderRequest req;
+            req.type = MASS_CANCEL;
+            req.symbol_id = symbol_id;
+            req.client_id = client_id;
+            req.side = side;
+            return req;
+        }
+
+        static OrderRequest purge_day_orders()
+        {
+            OrderRequest req;
+            req.type = PURGE_DAY;
+            req.symbol_id = IMatchingEngine::ALL_SYMBOLS;
+            return req;
+        }
     };
 
 } // namespace micromatch::core
\ No newline at end of file
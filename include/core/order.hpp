@@ -46,42 +46,47 @@ namespace micromatch::core
     struct alignas(64) Order
     {
         // First 8 bytes
-        uint64_t order_id;
+        uint64_t order_id{0};
 
         // Next 8 bytes
-        uint64_t symbol_id;
+        uint64_t symbol_id{0};
 
         // Next 8 bytes - price in fixed-point (6 decimal places)
         // e.g., $123.456789 = 123456789
-        int64_t price;
+        int64_t price{0};
 
         // Next 8 bytes
-        uint32_t quantity;
-        uint32_t executed_quantity;
+        uint32_t quantity{0};
+        uint32_t executed_quantity{0};
 
         // Next 8 bytes
-        uint64_t timestamp_ns;
+        uint64_t timestamp_ns{0};
 
         // Next 8 bytes
-        uint64_t client_id;
+        uint64_t client_id{0};
 
         // Next 8 bytes
-        uint32_t sequence_number;
-        Side side;
-        OrderType type;
-        OrderStatus status;
-        TimeInForce tif;
-
-        // Last 8 bytes - padding to reach 64 bytes
-        uint8_t padding[8];
+        uint32_t sequence_number{0};
+        Side side{Side::BUY};
+        OrderType type{OrderType::LIMIT};
+        OrderStatus status{OrderStatus::NEW};
+        TimeInForce tif{TimeInForce::DAY};
+
+        // Last 8 bytes - trigger price for STOP / STOP_LIMIT orders, or the
+        // steady-clock deadline in ns for GTD orders (stops cannot be GTD)
+        union
+        {
+            int64_t stop_price{0};
+            uint64_t expire_time_ns;
+        };
 
-        // Default constructor
+        // Default constructor (a resting DAY limit order with every field zeroed)
         Order() noexcept = default;
 
         // Constructor for limit orders
         Order(uint64_t id, uint64_t symbol, int64_t px, uint32_t qty,
               Side s, uint64_t client = 0) noexcept
-            : order_id(id), symbol_id(symbol), price(px), quantity(qty), executed_quantity(0), timestamp_ns(std::chrono::steady_clock::now().time_since_epoch().count()), client_id(client), sequence_number(0), side(s), type(OrderType::LIMIT), status(OrderStatus::NEW), tif(TimeInForce::DAY), padding{} {}
+            : order_id(id), symbol_id(symbol), price(px), quantity(qty), executed_quantity(0), timestamp_ns(std::chrono::steady_clock::now().time_since_epoch().count()), client_id(client), sequence_number(0), side(s), type(OrderType::LIMIT), status(OrderStatus::NEW), tif(TimeInForce::DAY), stop_price(0) {}
 
         // Check if order is buy side
         [[nodiscard]] constexpr bool is_buy() const noexcept
@@ -169,6 +174,27 @@ namespace micromatch::core
               timestamp_ns(std::chrono::steady_clock::now().time_since_epoch().count()),
               padding{} {}
 
+        // Constructor for a fill against a resting order known only by id;
+        // the passive side is the opposite of the aggressor's
+        Trade(uint64_t id, const Order &aggressive, uint64_t passive_id,
+              int64_t exec_price, uint32_t qty) noexcept
+            : Trade(id, aggressive, passive_id, exec_price, qty,
+                    std::chrono::steady_clock::now().time_since_epoch().count()) {}
+
+        // As above, stamped with a given time instead of the clock
+        Trade(uint64_t id, const Order &aggressive, uint64_t passive_id,
+              int64_t exec_price, uint32_t qty, uint64_t time_ns) noexcept
+            : trade_id(id),
+              aggressive_order_id(aggressive.order_id),
+              passive_order_id(passive_id),
+              symbol_id(aggressive.symbol_id),
+              price(exec_price),
+              quantity(qty),
+              side(aggressive.side),
+              is_maker_buy(aggressive.side == Side::SELL),
+              timestamp_ns(time_ns),
+              padding{} {}
+
         // Convenience getters for buy/sell order IDs
         uint64_t buy_order_id() const noexcept
         {
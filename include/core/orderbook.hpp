@@ -1,6 +1,10 @@
 #pragma once
 
 #include "order.hpp"
+#include "utils/slab_pool.hpp"
+#include <array>
+#include <cstddef>
+#include <iosfwd>
 #include <vector>
 #include <memory>
 #include <optional>
@@ -9,8 +13,59 @@ namespace micromatch::core
 {
 
     // Forward declarations
+    template <template <typename> class Levels>
     class OrderBookImpl;
 
+    // How a modify request was applied
+    enum class ModifyPath : uint8_t
+    {
+        NOT_FOUND = 0, // No resting order with that id
+        REJECTED = 1,  // Invalid price; the order is left untouched
+        IN_PLACE = 2,  // Quantity reduced at the same price; queue position kept
+        REQUEUED = 3,  // Quantity increased at the same price; moved to the back of its level
+        REPRICED = 4,  // Moved to a new price level (and matched if it crossed)
+        CANCELLED = 5  // New quantity of zero removed the order
+    };
+
+    // Price level information
+    struct PriceLevel
+    {
+        int64_t price{0};
+        uint32_t total_volume{0};
+        uint32_t order_count{0};
+
+        PriceLevel() noexcept = default;
+        PriceLevel(int64_t p, uint32_t v, uint32_t c) noexcept
+            : price(p), total_volume(v), order_count(c) {}
+    };
+
+    // Order book depth (top N levels)
+    // Fixed-size arrays so a snapshot is a plain copy with no allocation;
+    // only the first bid_count / ask_count entries are meaningful.
+    struct OrderBookDepth
+    {
+        static constexpr size_t MAX_DEPTH = 10;
+
+        uint64_t symbol_id;
+        std::array<PriceLevel, MAX_DEPTH> bids; // Sorted highest to lowest
+        std::array<PriceLevel, MAX_DEPTH> asks; // Sorted lowest to highest
+        uint32_t bid_count{0};
+        uint32_t ask_count{0};
+        uint64_t timestamp_ns;
+
+        OrderBookDepth(uint64_t sym = 0) noexcept
+            : symbol_id(sym), timestamp_ns(std::chrono::steady_clock::now().time_since_epoch().count()) {}
+    };
+
+    // Outcome of a call auction uncross
+    struct AuctionResult
+    {
+        int64_t price{0};     // Equilibrium price, 0 if nothing executed
+        uint64_t volume{0};   // Quantity executed at that price
+        int64_t imbalance{0}; // Demand minus supply at the price (> 0: buy surplus)
+        size_t held_stops{0}; // Stops the print triggered into the next auction
+    };
+
     // Order book interface
     class IOrderBook
     {
@@ -18,20 +73,100 @@ namespace micromatch::core
         virtual ~IOrderBook() = default;
 
         // Add a new order to the book
-        // Returns trades if the order matches existing orders
-        [[nodiscard]] virtual std::vector<Trade> add_order(Order order) = 0;
+        // Fills are appended to `trades`, which the caller owns and reuses so
+        // the match path never allocates once the buffer has grown to size.
+        // STOP / STOP_LIMIT orders are held until a trade reaches their
+        // stop_price and then enter as market / limit orders; fills from
+        // stops released by this call are appended to `trades` as well.
+        // Returns the number of trades appended.
+        virtual size_t add_order(const Order &order, std::vector<Trade> &trades) = 0;
+
+        // Convenience overload returning trades in a fresh vector
+        std::vector<Trade> add_order(const Order &order)
+        {
+            std::vector<Trade> trades;
+            add_order(order, trades);
+            return trades;
+        }
 
         // Cancel an existing order
         // Returns true if order was found and cancelled
         [[nodiscard]] virtual bool cancel_order(uint64_t order_id) = 0;
 
         // Modify an existing order (price and/or quantity)
-        // This is typically implemented as cancel + add new
+        // Returns the order as it stands after the modification
         [[nodiscard]] virtual std::optional<Order> modify_order(
             uint64_t order_id,
             int64_t new_price,
             uint32_t new_quantity) = 0;
 
+        // Modify an existing order, appending any fills caused by a price
+        // change to `trades`. Reducing quantity at the same price keeps time
+        // priority; any other change moves the order to the back of its
+        // (possibly new) level without reallocating it.
+        // Returns which path was taken.
+        virtual ModifyPath modify_order(uint64_t order_id, int64_t new_price,
+                                        uint32_t new_quantity, std::vector<Trade> &trades) = 0;
+
+        // Call auction: from begin_auction() until uncross() incoming orders
+        // rest without matching, so the book may stand crossed. Market
+        // orders queue ahead of every limit on their side; IOC and FOK
+        // orders are rejected since they cannot rest.
+        virtual void begin_auction() = 0;
+
+        [[nodiscard]] virtual bool in_auction() const = 0;
+
+        // Execute the auction at a single equilibrium price: maximum
+        // executable volume, then minimum imbalance, then closest to
+        // `reference_price` (0 = last trade price). Fills are appended to
+        // `trades`, unfilled market orders are cancelled and the book
+        // returns to continuous matching. With `next_auction` the book
+        // instead stays in call-auction mode for the next interval, so
+        // stops triggered by the print rest for that auction rather than
+        // matching on their own.
+        virtual AuctionResult uncross(std::vector<Trade> &trades, int64_t reference_price = 0,
+                                      bool next_auction = false) = 0;
+
+        // Cancel every resting order of `client_id` (0 = every client),
+        // optionally on one side only; stops and auction orders included.
+        // Each client's orders are chained in an intrusive list, so this
+        // walks just the orders it cancels without looking any of them up.
+        // Orders with client_id 0 are not tracked per client.
+        // Returns the number of orders cancelled.
+        virtual size_t mass_cancel(uint64_t client_id, std::optional<Side> side = std::nullopt) = 0;
+
+        // Cancel GTD orders whose expire_time_ns has passed by `now_ns`
+        // (steady-clock). Each order is on a timing wheel, so a call with
+        // nothing due is O(1). Returns the number of orders expired.
+        virtual size_t expire_orders(uint64_t now_ns) = 0;
+
+        // End of session: cancel every DAY order (stops and auction orders
+        // included) and keep GTC / GTD ones. When no other order has been
+        // accepted since the last purge, the pool and price levels are
+        // released wholesale instead of order by order.
+        // Returns the number of orders removed.
+        virtual size_t purge_day_orders() = 0;
+
+        // Append a flat checkpoint image of the book to `out`. The image
+        // holds no pointers: resting orders are written level by level in
+        // price-time order, numbered densely in that order, followed by
+        // the raw id index table keyed to those numbers.
+        virtual void write_checkpoint(std::ostream &out) const = 0;
+
+        // Replace the book's contents with an image from write_checkpoint()
+        // for the same symbol, read in place (e.g. from a MappedFile) in a
+        // single linear pass that relinks every order; the id index is
+        // copied rather than rebuilt. Trade ids continue from the image.
+        // Returns the bytes consumed, 0 if the image is malformed, in which
+        // case the book is left empty.
+        virtual size_t restore_checkpoint(const std::byte *data, size_t size) = 0;
+
+        // Stamp trades and requeued orders with `now_ns` instead of reading
+        // the steady clock per event; 0 restores the clock. The matching
+        // engine pins this to each journaled event's time so a replay of
+        // the journal reproduces trades exactly.
+        virtual void set_clock(uint64_t now_ns) = 0;
+
         // Get current best bid price (highest buy price)
         [[nodiscard]] virtual std::optional<int64_t> best_bid() const = 0;
 
@@ -47,15 +182,50 @@ namespace micromatch::core
         // Get the symbol this book is for
         [[nodiscard]] virtual uint64_t symbol_id() const = 0;
 
-        // Get total number of orders in the book
+        // Top `n` levels per side (capped at OrderBookDepth::MAX_DEPTH),
+        // copied from a cache the book keeps up to date as levels change
+        [[nodiscard]] virtual OrderBookDepth depth(size_t n = OrderBookDepth::MAX_DEPTH) const = 0;
+
+        // Get total number of orders in the book, including untriggered stops
         [[nodiscard]] virtual size_t total_orders() const = 0;
 
+        // Occupancy of the pool backing resting orders
+        [[nodiscard]] virtual utils::PoolStats pool_stats() const = 0;
+
         // Clear all orders (typically at end of day)
         virtual void clear() = 0;
     };
 
-    // Factory function to create an order book
+    // How an order book stores its price levels
+    enum class PriceLevelStorage : uint8_t
+    {
+        MAP = 0,   // Ordered tree keyed by price; suits sparse or wide books
+        LADDER = 1 // Dense tick-indexed array around the touch with tree overflow
+    };
+
+    // Order book construction parameters
+    struct OrderBookConfig
+    {
+        // Resting orders pre-allocated in the book's pool; the pool grows in
+        // chunks beyond this and never shrinks during a session
+        size_t initial_order_capacity = 4096;
+
+        PriceLevelStorage level_storage = PriceLevelStorage::MAP;
+
+        // Ladder settings: price increment between slots, number of slots per
+        // side and the price to centre the window on (0 = first order's price)
+        int64_t tick_size = 1;
+        size_t ladder_levels = 4096;
+        int64_t reference_price = 0;
+
+        // Resolution of the GTD expiry wheel; orders expire at most one tick late
+        uint64_t expiry_tick_ns = 1'000'000;
+    };
+
+    // Factory functions to create an order book
     [[nodiscard]] std::unique_ptr<IOrderBook> create_order_book(uint64_t symbol_id);
+    [[nodiscard]] std::unique_ptr<IOrderBook> create_order_book(uint64_t symbol_id,
+                                                                const OrderBookConfig &config);
 
     // Market data snapshot
     struct MarketDataSnapshot
@@ -73,33 +243,4 @@ namespace micromatch::core
             : symbol_id(book.symbol_id()), best_bid(book.best_bid()), best_ask(book.best_ask()), bid_volume(best_bid ? book.volume_at_price(*best_bid, Side::BUY) : 0), ask_volume(best_ask ? book.volume_at_price(*best_ask, Side::SELL) : 0), bid_orders(best_bid ? book.order_count_at_price(*best_bid, Side::BUY) : 0), ask_orders(best_ask ? book.order_count_at_price(*best_ask, Side::SELL) : 0), timestamp_ns(std::chrono::steady_clock::now().time_since_epoch().count()) {}
     };
 
-    // Price level information
-    struct PriceLevel
-    {
-        int64_t price;
-        uint32_t total_volume;
-        uint32_t order_count;
-
-        PriceLevel(int64_t p, uint32_t v, uint32_t c) noexcept
-            : price(p), total_volume(v), order_count(c) {}
-    };
-
-    // Order book depth (top N levels)
-    struct OrderBookDepth
-    {
-        static constexpr size_t MAX_DEPTH = 10;
-
-        uint64_t symbol_id;
-        std::vector<PriceLevel> bids; // Sorted highest to lowest
-        std::vector<PriceLevel> asks; // Sorted lowest to highest
-        uint64_t timestamp_ns;
-
-        OrderBookDepth(uint64_t sym) noexcept
-            : symbol_id(sym), timestamp_ns(std::chrono::steady_clock::now().time_since_epoch().count())
-        {
-            bids.reserve(MAX_DEPTH);
-            asks.reserve(MAX_DEPTH);
-        }
-    };
-
 } // namespace micromatch::core
\ No newline at end of file
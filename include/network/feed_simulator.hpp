@@ -2,6 +2,7 @@
 
 #include "market_data.hpp"
 #include "utils/spsc_queue.hpp"
+#include "utils/spsc_ring.hpp"
 #include <atomic>
 #include <random>
 #include <thread>
@@ -27,16 +28,20 @@ namespace micromatch::network
         uint64_t volatile_jitter_multiplier = 100; // 100x jitter during volatility
     };
 
-    // Feed simulator that injects realistic latency patterns
-    class FeedSimulator
+    // Feed simulator that injects realistic latency patterns. Queue holds
+    // published updates until the worker delivers them and needs the
+    // try_push/try_pop interface: SPSCRing is bounded and never
+    // allocates, SPSCQueue never fills but allocates per message.
+    template <typename Queue>
+    class BasicFeedSimulator
     {
     public:
         using MessageCallback = std::function<void(const MarketDataUpdate &, const FeedStats &)>;
 
-        FeedSimulator(char feed_id, const FeedConfig &config = FeedConfig())
+        BasicFeedSimulator(char feed_id, const FeedConfig &config = FeedConfig())
             : feed_id_(feed_id), config_(config), running_(false), sequence_number_(config.sequence_start), rng_(std::random_device{}()), latency_dist_(0.0, 1.0), spike_dist_(0.0, 1.0), drop_dist_(0.0, 1.0) {}
 
-        ~FeedSimulator()
+        ~BasicFeedSimulator()
         {
             stop();
         }
@@ -49,7 +54,7 @@ namespace micromatch::network
                 return;
             }
 
-            worker_thread_ = std::thread(&FeedSimulator::worker_loop, this);
+            worker_thread_ = std::thread(&BasicFeedSimulator::worker_loop, this);
         }
 
         // Stop the feed
@@ -73,8 +78,7 @@ namespace micromatch::network
             Quote quote(symbol_id, bid, ask, bid_size, ask_size, feed_id_);
             quote.sequence_number = sequence_number_.fetch_add(1);
 
-            MarketDataUpdate update(quote);
-            pending_updates_.enqueue(std::move(update));
+            push(MarketDataUpdate(quote));
         }
 
         void publish_trade(uint64_t symbol_id, int64_t price, uint32_t quantity, bool is_buy)
@@ -82,8 +86,7 @@ namespace micromatch::network
             TradeTick trade(symbol_id, price, quantity, feed_id_, is_buy);
             trade.sequence_number = sequence_number_.fetch_add(1);
 
-            MarketDataUpdate update(trade);
-            pending_updates_.enqueue(std::move(update));
+            push(MarketDataUpdate(trade));
         }
 
         // Set callback for processed messages
@@ -107,12 +110,26 @@ namespace micromatch::network
         char get_feed_id() const { return feed_id_; }
 
     private:
+        // Queue an update, waiting for the worker while the queue is full.
+        // With no worker running to make room, the update is discarded.
+        void push(MarketDataUpdate &&update)
+        {
+            while (!pending_updates_.try_push(std::move(update)))
+            {
+                if (!running_.load(std::memory_order_acquire))
+                {
+                    return;
+                }
+                std::this_thread::yield();
+            }
+        }
+
         void worker_loop()
         {
+            MarketDataUpdate update;
             while (running_.load(std::memory_order_acquire))
             {
-                auto update_opt = pending_updates_.dequeue();
-                if (!update_opt)
+                if (!pending_updates_.try_pop(update))
                 {
                     std::this_thread::sleep_for(std::chrono::microseconds(1));
                     continue;
@@ -149,7 +166,7 @@ namespace micromatch::network
                 // Deliver the update
                 if (callback_)
                 {
-                    callback_(*update_opt, stats_);
+                    callback_(update, stats_);
                 }
             }
         }
@@ -199,7 +216,7 @@ namespace micromatch::network
         std::atomic<bool> running_;
         std::atomic<uint64_t> sequence_number_;
 
-        utils::SPSCQueue<MarketDataUpdate> pending_updates_;
+        Queue pending_updates_;
         MessageCallback callback_;
         FeedStats stats_;
 
@@ -212,4 +229,7 @@ namespace micromatch::network
         std::uniform_real_distribution<double> drop_dist_;
     };
 
+    // Default feed: a fixed ring, so publishing never allocates
+    using FeedSimulator = BasicFeedSimulator<utils::SPSCRing<MarketDataUpdate, 4096>>;
+
 } // namespace micromatch::network
\ No newline at end of file
@@ -0,0 +1,396 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace micromatch::utils
+{
+
+    /**
+     * Open-addressing hash map keyed by 64-bit ids (Robin Hood hashing)
+     *
+     * Entries live inline in one power-of-two array, so lookups touch a
+     * single run of adjacent slots instead of chasing bucket nodes. Each slot
+     * stores its probe distance; inserts displace entries that are closer to
+     * their home slot, which keeps probe lengths short and lets lookups stop
+     * as soon as they reach a slot whose entry is richer than the probe.
+     * Deletion shifts the following cluster back by one slot, so there are
+     * no tombstones and no periodic cleanup.
+     *
+     * No allocation happens unless the map grows past its reserved size.
+     *
+     * @tparam V Value type (kept small and trivially copyable, e.g. a handle)
+     */
+    template <typename V>
+    class FlatIdMap
+    {
+    public:
+        struct Slot
+        {
+            uint64_t key;
+            V value;
+            uint32_t dist; // Probe distance + 1, 0 marks an empty slot
+        };
+
+    private:
+        static constexpr size_t MIN_CAPACITY = 16;
+
+        // Grow once size exceeds 7/8 of capacity
+        static constexpr size_t max_load(size_t capacity)
+        {
+            return capacity - capacity / 8;
+        }
+
+        std::unique_ptr<Slot[]> slots_;
+        size_t capacity_{0};
+        size_t mask_{0};
+        unsigned shift_{64};
+        size_t size_{0};
+        size_t grow_at_{0};
+
+        // Fibonacci hashing spreads sequential ids across the table
+        size_t home(uint64_t key) const noexcept
+        {
+            return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_);
+        }
+
+        void allocate(size_t capacity)
+        {
+            capacity_ = capacity;
+            mask_ = capacity - 1;
+            shift_ = 64 - static_cast<unsigned>(__builtin_ctzll(capacity));
+            slots_ = std::make_unique<Slot[]>(capacity);
+            for (size_t i = 0; i < capacity; ++i)
+            {
+                slots_[i].dist = 0;
+            }
+            grow_at_ = max_load(capacity);
+        }
+
+        // Continue inserting an entry known to be absent from slot i, where
+        // entry.dist already reflects the distance from its home slot
+        void place_from(size_t i, Slot entry) noexcept
+        {
+            for (;;)
+            {
+                Slot &slot = slots_[i];
+                if (slot.dist == 0)
+                {
+                    slot = entry;
+                    return;
+                }
+                if (slot.dist < entry.dist)
+                {
+                    std::swap(slot, entry);
+                }
+                i = (i + 1) & mask_;
+                ++entry.dist;
+            }
+        }
+
+        void rehash(size_t capacity)
+        {
+            auto old = std::move(slots_);
+            const size_t old_capacity = capacity_;
+            allocate(capacity);
+            for (size_t i = 0; i < old_capacity; ++i)
+            {
+                if (old[i].dist != 0)
+                {
+                    Slot entry = old[i];
+                    entry.dist = 1;
+                    place_from(home(entry.key), entry);
+                }
+            }
+        }
+
+        // Index of the slot holding key, capacity_ if absent
+        size_t locate(uint64_t key) const noexcept
+        {
+            if (capacity_ == 0)
+            {
+                return capacity_;
+            }
+            size_t i = home(key);
+            for (uint32_t dist = 1;; ++dist)
+            {
+                const Slot &slot = slots_[i];
+                if (slot.dist < dist)
+                {
+                    return capacity_; // Empty, or an entry richer than us: not present
+                }
+                if (slot.key == key)
+                {
+                    return i;
+                }
+                i = (i + 1) & mask_;
+            }
+        }
+
+        // Remove the entry at index by shifting its cluster back
+        void remove_at(size_t i) noexcept
+        {
+            size_t next = (i + 1) & mask_;
+            while (slots_[next].dist > 1)
+            {
+                slots_[i] = slots_[next];
+                --slots_[i].dist;
+                i = next;
+                next = (next + 1) & mask_;
+            }
+            slots_[i].dist = 0;
+            --size_;
+        }
+
+    public:
+        explicit FlatIdMap(size_t expected_size = 0)
+        {
+            reserve(expected_size);
+        }
+
+        // Delete copy operations
+        FlatIdMap(const FlatIdMap &) = delete;
+        FlatIdMap &operator=(const FlatIdMap &) = delete;
+
+        /**
+         * Size the table so `count` entries fit without rehashing
+         */
+        void reserve(size_t count)
+        {
+            size_t capacity = MIN_CAPACITY;
+            while (max_load(capacity) < count)
+            {
+                capacity <<= 1;
+            }
+            if (capacity > capacity_)
+            {
+                rehash(capacity);
+            }
+        }
+
+        /**
+         * Insert a new entry
+         * @return false if the key is already present
+         */
+        bool insert(uint64_t key, V value)
+        {
+            if (size_ >= grow_at_)
+            {
+                rehash(capacity_ ? capacity_ * 2 : MIN_CAPACITY);
+            }
+
+            size_t i = home(key);
+            Slot entry{key, value, 1};
+            for (;;)
+            {
+                Slot &slot = slots_[i];
+                if (slot.dist == 0)
+                {
+                    slot = entry;
+                    ++size_;
+                    return true;
+                }
+                if (slot.dist == entry.dist && slot.key == key)
+                {
+                    return false;
+                }
+                if (slot.dist < entry.dist)
+                {
+                    // The key would have been found before this slot; it is
+                    // absent, so continue as a plain displacement insert
+                    std::swap(slot, entry);
+                    i = (i + 1) & mask_;
+                    ++entry.dist;
+                    place_from(i, entry);
+                    ++size_;
+                    return true;
+                }
+                i = (i + 1) & mask_;
+                ++entry.dist;
+            }
+        }
+
+        /**
+         * @return Pointer to the value for key, nullptr if absent
+         */
+        [[nodiscard]] V *find(uint64_t key) noexcept
+        {
+            const size_t i = locate(key);
+            return (i != capacity_) ? &slots_[i].value : nullptr;
+        }
+
+        [[nodiscard]] const V *find(uint64_t key) const noexcept
+        {
+            const size_t i = locate(key);
+            return (i != capacity_) ? &slots_[i].value : nullptr;
+        }
+
+        [[nodiscard]] bool contains(uint64_t key) const noexcept
+        {
+            return locate(key) != capacity_;
+        }
+
+        /**
+         * Remove key
+         * @return true if it was present
+         */
+        bool erase(uint64_t key) noexcept
+        {
+            const size_t i = locate(key);
+            if (i == capacity_)
+            {
+                return false;
+            }
+            remove_at(i);
+            return true;
+        }
+
+        /**
+         * Remove key and return its value in a single probe
+         */
+        std::optional<V> extract(uint64_t key) noexcept
+        {
+            const size_t i = locate(key);
+            if (i == capacity_)
+            {
+                return std::nullopt;
+            }
+            V value = slots_[i].value;
+            remove_at(i);
+            return value;
+        }
+
+        /**
+         * Remove every entry for which pred(key, value) holds, in a single
+         * pass over the table rather than one probe per key
+         * @return Number of entries removed
+         */
+        template <typename Pred>
+        size_t erase_if(Pred &&pred)
+        {
+            if (size_ == 0)
+            {
+                return 0;
+            }
+
+            // Start just past an empty slot so no cluster wraps across the
+            // start of the scan; a removal shifts the next entry back into
+            // the current slot, which is then examined again
+            size_t start = 0;
+            while (slots_[start].dist != 0)
+            {
+                ++start;
+            }
+            size_t removed = 0;
+            size_t i = (start + 1) & mask_;
+            for (size_t visited = 0; visited < capacity_;)
+            {
+                Slot &slot = slots_[i];
+                if (slot.dist != 0 && pred(slot.key, slot.value))
+                {
+                    remove_at(i);
+                    ++removed;
+                    continue;
+                }
+                i = (i + 1) & mask_;
+                ++visited;
+            }
+            return removed;
+        }
+
+        /**
+         * Raw table of capacity() slots, for writing a table image
+         *
+         * Slot positions depend on the keys and their insertion history,
+         * not on the values, so an image whose values are rewritten (e.g.
+         * remapped handles) is still a valid table.
+         */
+        [[nodiscard]] const Slot *table() const noexcept
+        {
+            return slots_.get();
+        }
+
+        /**
+         * Replace the contents with a table image taken from table()
+         *
+         * Every occupied slot must sit at its key's home slot plus its
+         * stored distance, and exactly `size` slots must be occupied; with
+         * size below capacity there is then always an empty slot to end a
+         * probe. Values are not checked: the caller knows what they mean.
+         *
+         * @param capacity Slots in the image, a power of two
+         * @param size Occupied slots in the image
+         * @return false (and the map left empty) if the image cannot be a table
+         */
+        bool load_table(const Slot *image, size_t capacity, size_t size)
+        {
+            if (capacity < MIN_CAPACITY || (capacity & (capacity - 1)) != 0 ||
+                size > max_load(capacity))
+            {
+                clear();
+                return false;
+            }
+            if (capacity != capacity_)
+            {
+                allocate(capacity);
+            }
+            std::memcpy(slots_.get(), image, capacity * sizeof(Slot));
+
+            size_t occupied = 0;
+            for (size_t i = 0; i < capacity; ++i)
+            {
+                const Slot &slot = slots_[i];
+                if (slot.dist == 0)
+                {
+                    continue;
+                }
+                if (slot.dist > capacity || ((home(slot.key) + slot.dist - 1) & mask_) != i)
+                {
+                    clear();
+                    return false;
+                }
+                ++occupied;
+            }
+            if (occupied != size)
+            {
+                clear();
+                return false;
+            }
+            size_ = size;
+            return true;
+        }
+
+        /**
+         * Visit every entry as fn(key, value)
+         */
+        template <typename Fn>
+        void for_each(Fn &&fn) const
+        {
+            for (size_t i = 0; i < capacity_; ++i)
+            {
+                if (slots_[i].dist != 0)
+                {
+                    fn(slots_[i].key, slots_[i].value);
+                }
+            }
+        }
+
+        void clear() noexcept
+        {
+            for (size_t i = 0; i < capacity_; ++i)
+            {
+                slots_[i].dist = 0;
+            }
+            size_ = 0;
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+        [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+    };
+
+} // namespace micromatch::utils
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace micromatch::utils
+{
+
+    /**
+     * Read-only memory mapping of a whole file
+     *
+     * The file is mapped private and read-only, with the kernel advised
+     * that it will be read front to back, so a restore that walks it once
+     * streams pages in without copying them through a read buffer first.
+     * The mapping is released when the object is destroyed.
+     */
+    class MappedFile
+    {
+    private:
+        const std::byte *data_{nullptr};
+        size_t size_{0};
+
+        void unmap() noexcept
+        {
+            if (data_)
+            {
+                ::munmap(const_cast<std::byte *>(data_), size_);
+                data_ = nullptr;
+                size_ = 0;
+            }
+        }
+
+    public:
+        MappedFile() = default;
+
+        /**
+         * Map `path`; check is_open() for failure
+         */
+        explicit MappedFile(const std::string &path)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return;
+            }
+
+            struct stat info;
+            if (::fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                void *mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                                      MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED)
+                {
+                    data_ = static_cast<const std::byte *>(mapped);
+                    size_ = static_cast<size_t>(info.st_size);
+                    ::madvise(mapped, size_, MADV_SEQUENTIAL);
+                }
+            }
+            ::close(fd); // The mapping keeps the file referenced
+        }
+
+        ~MappedFile()
+        {
+            unmap();
+        }
+
+        MappedFile(MappedFile &&other) noexcept
+            : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+        MappedFile &operator=(MappedFile &&other) noexcept
+        {
+            if (this != &other)
+            {
+                unmap();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+            }
+            return *this;
+        }
+
+        // Delete copy operations
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        [[nodiscard]] bool is_open() const noexcept { return data_ != nullptr; }
+        [[nodiscard]] const std::byte *data() const noexcept { return data_; }
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+    };
+
+} // namespace micromatch::utils
@@ -1,11 +1,17 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <cstddef>
+#include <cstdint>
+#include <algorithm>
 #include <array>
+#include <span>
 #include <thread>
+#include <type_traits>
+#include "wait_strategy.hpp"
 
 namespace micromatch::utils
 {
@@ -16,6 +22,17 @@ namespace micromatch::utils
      * Bounded queue suitable for monitoring, logging, and multi-threaded scenarios.
      * Uses a ring buffer with atomic indices for lock-free operation.
      *
+     * The batch calls (try_push_n, pop_n, consume) claim a run of
+     * consecutive cells with a single CAS on the shared index instead of
+     * one CAS per item; each cell is still handed over by its own
+     * sequence number.
+     *
+     * push_wait() / pop_wait() block instead of failing: they spin
+     * briefly, then sleep on a futex until the other side makes room or
+     * adds an item. Every successful operation checks for sleepers, which
+     * costs a fence; the wake-up syscall is only made when a thread is
+     * actually asleep.
+     *
      * @tparam T Type of elements stored in the queue
      * @tparam Size Maximum number of elements (must be power of 2)
      */
@@ -39,7 +56,91 @@ namespace micromatch::utils
         alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
         alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_{0};
 
+        // Sleepers in pop_wait() and push_wait()
+        EventCount not_empty_;
+        EventCount not_full_;
+
         static constexpr size_t MASK = Size - 1;
+        static constexpr uint32_t WAIT_SPINS = 64;
+
+        // Spin on `attempt` (on more than one CPU), then sleep on `event`
+        // between attempts until it succeeds or `timeout` passes
+        template <typename Attempt>
+        static bool wait_for(EventCount &event, Attempt &&attempt, std::chrono::nanoseconds timeout)
+        {
+            static const uint32_t spins = std::thread::hardware_concurrency() > 1 ? WAIT_SPINS : 0;
+            for (uint32_t i = 0; i < spins; ++i)
+            {
+                if (attempt())
+                {
+                    return true;
+                }
+                cpu_relax();
+            }
+
+            const auto deadline = std::chrono::steady_clock::now() + timeout;
+            for (;;)
+            {
+                const uint32_t key = event.prepare_wait();
+                if (attempt())
+                {
+                    event.cancel_wait();
+                    return true;
+                }
+                const auto remaining = deadline - std::chrono::steady_clock::now();
+                if (remaining <= std::chrono::nanoseconds::zero())
+                {
+                    event.cancel_wait();
+                    return false;
+                }
+                event.wait(key, remaining);
+            }
+        }
+
+        /**
+         * Claim up to `wanted` consecutive cells at `index` with one CAS.
+         * A cell is ready when its sequence is its position plus Offset
+         * (0: free for a producer, 1: holding data for a consumer).
+         * @param pos Set to the first claimed position
+         * @return Number of cells claimed (0 if none are ready)
+         */
+        template <size_t Offset>
+        size_t claim(std::atomic<size_t> &index, size_t wanted, size_t &pos)
+        {
+            wanted = std::min(wanted, Size);
+            pos = index.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                size_t ready = 0;
+                bool behind = false;
+                while (ready < wanted)
+                {
+                    const size_t seq = buffer_[(pos + ready) & MASK].sequence.load(std::memory_order_acquire);
+                    const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + ready + Offset);
+                    if (diff != 0)
+                    {
+                        behind = ready == 0 && diff > 0;
+                        break;
+                    }
+                    ++ready;
+                }
+
+                if (ready == 0)
+                {
+                    if (!behind)
+                    {
+                        return 0; // Full (producers) or empty (consumers)
+                    }
+                    // Another thread is ahead, retry
+                    pos = index.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (index.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed))
+                {
+                    return ready;
+                }
+            }
+        }
 
     public:
         MPMCQueue()
@@ -81,6 +182,7 @@ namespace micromatch::utils
                         // We got the slot
                         cell.data = std::forward<U>(value);
                         cell.sequence.store(pos + 1, std::memory_order_release);
+                        not_empty_.notify();
                         return true;
                     }
                 }
@@ -97,6 +199,88 @@ namespace micromatch::utils
             }
         }
 
+        /**
+         * Try to construct an item in place
+         * @return true if successful, false if queue is full
+         */
+        template <typename... Args>
+        bool emplace(Args &&...args)
+        {
+            size_t pos;
+            if (claim<0>(enqueue_pos_, 1, pos) == 0)
+            {
+                return false;
+            }
+            Cell &cell = buffer_[pos & MASK];
+            if constexpr (std::is_nothrow_constructible_v<T, Args...>)
+            {
+                std::destroy_at(&cell.data);
+                std::construct_at(&cell.data, std::forward<Args>(args)...);
+            }
+            else
+            {
+                cell.data = T(std::forward<Args>(args)...);
+            }
+            cell.sequence.store(pos + 1, std::memory_order_release);
+            not_empty_.notify();
+            return true;
+        }
+
+        /**
+         * Copy as many leading items as there are free cells
+         * @return Number of items enqueued
+         */
+        size_t try_push_n(std::span<const T> items)
+        {
+            size_t pos;
+            const size_t count = claim<0>(enqueue_pos_, items.size(), pos);
+            for (size_t i = 0; i < count; ++i)
+            {
+                Cell &cell = buffer_[(pos + i) & MASK];
+                cell.data = items[i];
+                cell.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            if (count > 0)
+            {
+                not_empty_.notify(static_cast<uint32_t>(count));
+            }
+            return count;
+        }
+
+        /**
+         * Move up to `max` items into `out`
+         * @return Number of items dequeued
+         */
+        size_t pop_n(T *out, size_t max)
+        {
+            return consume([&out](T &item)
+                           { *out++ = std::move(item); },
+                           max);
+        }
+
+        /**
+         * Claim up to `max` items and call fn(T&) on each in its cell,
+         * releasing each cell to producers as soon as fn returns
+         * @return Number of items consumed
+         */
+        template <typename Fn>
+        size_t consume(Fn &&fn, size_t max = SIZE_MAX)
+        {
+            size_t pos;
+            const size_t count = claim<1>(dequeue_pos_, max, pos);
+            for (size_t i = 0; i < count; ++i)
+            {
+                Cell &cell = buffer_[(pos + i) & MASK];
+                fn(cell.data);
+                cell.sequence.store(pos + i + Size, std::memory_order_release);
+            }
+            if (count > 0)
+            {
+                not_full_.notify(static_cast<uint32_t>(count));
+            }
+            return count;
+        }
+
         /**
          * Try to dequeue an item
          * @return Optional containing the dequeued item if successful
@@ -120,6 +304,7 @@ namespace micromatch::utils
                         // We got the data
                         T data = std::move(cell.data);
                         cell.sequence.store(pos + Size, std::memory_order_release);
+                        not_full_.notify();
                         return data;
                     }
                 }
@@ -191,6 +376,38 @@ namespace micromatch::utils
             return std::nullopt;
         }
 
+        /**
+         * Enqueue, sleeping while the queue is full
+         * @param value Item to enqueue (left untouched on timeout)
+         * @param timeout Longest to wait for room
+         * @return true if successful, false on timeout
+         */
+        template <typename U>
+        bool push_wait(U &&value, std::chrono::nanoseconds timeout = std::chrono::hours(24))
+        {
+            return wait_for(
+                not_full_, [&]
+                { return try_enqueue(std::forward<U>(value)); },
+                timeout);
+        }
+
+        /**
+         * Dequeue, sleeping while the queue is empty
+         * @param timeout Longest to wait for an item
+         * @return Optional containing the dequeued item, empty on timeout
+         */
+        std::optional<T> pop_wait(std::chrono::nanoseconds timeout = std::chrono::hours(24))
+        {
+            std::optional<T> result;
+            wait_for(
+                not_empty_, [&]
+                {
+                    result = try_dequeue();
+                    return result.has_value(); },
+                timeout);
+            return result;
+        }
+
         /**
          * Check if queue is empty (approximate)
          * @return true if empty
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace micromatch::utils
+{
+
+    /**
+     * Three-level occupancy bitmap over a fixed number of slots
+     *
+     * Leaf words hold one bit per slot, each summary bit records whether the
+     * corresponding leaf word is non-zero, and each top bit whether the
+     * corresponding summary word is non-zero. Finding the next or previous
+     * set slot therefore costs at most one masked word scan per level plus
+     * a count-trailing/leading-zeros, independent of how sparse the slots are.
+     * Supports up to 64^3 = 262144 slots with a single-word top level; larger
+     * sizes fall back to scanning the top level word by word.
+     */
+    class OccupancyBitmap
+    {
+    public:
+        static constexpr size_t NPOS = SIZE_MAX;
+
+    private:
+        static constexpr size_t WORD_BITS = 64;
+        static constexpr size_t WORD_SHIFT = 6;
+        static constexpr size_t WORD_MASK = WORD_BITS - 1;
+
+        size_t size_;
+        std::vector<uint64_t> leaf_;
+        std::vector<uint64_t> summary_;
+        std::vector<uint64_t> top_;
+
+        static size_t words_for(size_t bits)
+        {
+            return (bits + WORD_MASK) >> WORD_SHIFT;
+        }
+
+        // Bits at positions >= bit
+        static uint64_t mask_from(size_t bit)
+        {
+            return ~uint64_t{0} << (bit & WORD_MASK);
+        }
+
+        // Bits at positions <= bit
+        static uint64_t mask_upto(size_t bit)
+        {
+            return ~uint64_t{0} >> (WORD_MASK - (bit & WORD_MASK));
+        }
+
+        static size_t lowest(uint64_t word)
+        {
+            return static_cast<size_t>(__builtin_ctzll(word));
+        }
+
+        static size_t highest(uint64_t word)
+        {
+            return WORD_MASK - static_cast<size_t>(__builtin_clzll(word));
+        }
+
+        // First set bit at index >= from in a word array, NPOS if none
+        static size_t scan_forward(const std::vector<uint64_t> &words, size_t from)
+        {
+            size_t w = from >> WORD_SHIFT;
+            if (w >= words.size())
+            {
+                return NPOS;
+            }
+            uint64_t bits = words[w] & mask_from(from);
+            while (!bits)
+            {
+                if (++w >= words.size())
+                {
+                    return NPOS;
+                }
+                bits = words[w];
+            }
+            return (w << WORD_SHIFT) + lowest(bits);
+        }
+
+        // Last set bit at index <= from in a word array, NPOS if none
+        static size_t scan_backward(const std::vector<uint64_t> &words, size_t from)
+        {
+            size_t w = from >> WORD_SHIFT;
+            if (w >= words.size())
+            {
+                w = words.size() - 1;
+                from = (w << WORD_SHIFT) + WORD_MASK;
+            }
+            uint64_t bits = words[w] & mask_upto(from);
+            while (!bits)
+            {
+                if (w-- == 0)
+                {
+                    return NPOS;
+                }
+                bits = words[w];
+            }
+            return (w << WORD_SHIFT) + highest(bits);
+        }
+
+    public:
+        explicit OccupancyBitmap(size_t size)
+            : size_(size),
+              leaf_(words_for(size), 0),
+              summary_(words_for(leaf_.size()), 0),
+              top_(words_for(summary_.size()), 0) {}
+
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+
+        [[nodiscard]] bool test(size_t index) const noexcept
+        {
+            return (leaf_[index >> WORD_SHIFT] >> (index & WORD_MASK)) & 1;
+        }
+
+        [[nodiscard]] bool any() const noexcept
+        {
+            for (uint64_t word : top_)
+            {
+                if (word)
+                    return true;
+            }
+            return false;
+        }
+
+        void set(size_t index) noexcept
+        {
+            const size_t l = index >> WORD_SHIFT;
+            const size_t s = l >> WORD_SHIFT;
+            leaf_[l] |= uint64_t{1} << (index & WORD_MASK);
+            summary_[s] |= uint64_t{1} << (l & WORD_MASK);
+            top_[s >> WORD_SHIFT] |= uint64_t{1} << (s & WORD_MASK);
+        }
+
+        void clear(size_t index) noexcept
+        {
+            const size_t l = index >> WORD_SHIFT;
+            leaf_[l] &= ~(uint64_t{1} << (index & WORD_MASK));
+            if (leaf_[l])
+            {
+                return;
+            }
+            const size_t s = l >> WORD_SHIFT;
+            summary_[s] &= ~(uint64_t{1} << (l & WORD_MASK));
+            if (summary_[s])
+            {
+                return;
+            }
+            top_[s >> WORD_SHIFT] &= ~(uint64_t{1} << (s & WORD_MASK));
+        }
+
+        void reset() noexcept
+        {
+            std::fill(leaf_.begin(), leaf_.end(), 0);
+            std::fill(summary_.begin(), summary_.end(), 0);
+            std::fill(top_.begin(), top_.end(), 0);
+        }
+
+        /**
+         * Lowest set index >= from
+         * @return Index, or NPOS if there is none
+         */
+        [[nodiscard]] size_t find_next(size_t from) const noexcept
+        {
+            if (from >= size_)
+            {
+                return NPOS;
+            }
+
+            // Same leaf word
+            size_t l = from >> WORD_SHIFT;
+            uint64_t bits = leaf_[l] & mask_from(from);
+            if (bits)
+            {
+                return (l << WORD_SHIFT) + lowest(bits);
+            }
+
+            // Next non-empty leaf word within the same summary word
+            ++l;
+            size_t s = l >> WORD_SHIFT;
+            if (s >= summary_.size())
+            {
+                return NPOS;
+            }
+            bits = summary_[s] & mask_from(l);
+            if (!bits)
+            {
+                // Next non-empty summary word via the top level
+                s = scan_forward(top_, s + 1);
+                if (s == NPOS)
+                {
+                    return NPOS;
+                }
+                bits = summary_[s];
+            }
+            l = (s << WORD_SHIFT) + lowest(bits);
+            return (l << WORD_SHIFT) + lowest(leaf_[l]);
+        }
+
+        /**
+         * Highest set index <= from
+         * @return Index, or NPOS if there is none
+         */
+        [[nodiscard]] size_t find_prev(size_t from) const noexcept
+        {
+            if (size_ == 0)
+            {
+                return NPOS;
+            }
+            if (from >= size_)
+            {
+                from = size_ - 1;
+            }
+
+            // Same leaf word
+            size_t l = from >> WORD_SHIFT;
+            uint64_t bits = leaf_[l] & mask_upto(from);
+            if (bits)
+            {
+                return (l << WORD_SHIFT) + highest(bits);
+            }
+
+            // Previous non-empty leaf word within the same summary word
+            if (l == 0)
+            {
+                return NPOS;
+            }
+            --l;
+            size_t s = l >> WORD_SHIFT;
+            bits = summary_[s] & mask_upto(l);
+            if (!bits)
+            {
+                // Previous non-empty summary word via the top level
+                if (s == 0)
+                {
+                    return NPOS;
+                }
+                s = scan_backward(top_, s - 1);
+                if (s == NPOS)
+                {
+                    return NPOS;
+                }
+                bits = summary_[s];
+            }
+            l = (s << WORD_SHIFT) + highest(bits);
+            return (l << WORD_SHIFT) + highest(leaf_[l]);
+        }
+
+        [[nodiscard]] size_t first() const noexcept { return find_next(0); }
+        [[nodiscard]] size_t last() const noexcept { return find_prev(size_ - 1); }
+    };
+
+} // namespace micromatch::utils
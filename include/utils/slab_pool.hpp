@@ -0,0 +1,258 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace micromatch::utils
+{
+
+    // Snapshot of pool occupancy
+    struct PoolStats
+    {
+        size_t capacity{0};   // Slots currently owned by the pool
+        size_t in_use{0};     // Slots handed out and not yet released
+        size_t high_water{0}; // Maximum in_use observed since construction
+        size_t chunks{0};     // Number of chunks allocated
+    };
+
+    /**
+     * Slab allocator with an intrusive free list
+     *
+     * Objects live in fixed-size chunks that are allocated up front and grown
+     * on demand. Chunks are never returned to the system until the pool is
+     * destroyed, so once the pool has reached its working size allocate() and
+     * release() never touch the heap. Released slots are reused LIFO to keep
+     * recently touched memory hot.
+     *
+     * Every slot has a stable 32-bit handle (chunk << CHUNK_SHIFT | offset)
+     * that stays valid for the lifetime of the pool and can be used to index
+     * parallel per-slot arrays.
+     *
+     * @tparam T Object type (must be trivially destructible)
+     * @tparam ChunkShift log2 of the number of slots per chunk
+     */
+    template <typename T, size_t ChunkShift = 8>
+    class SlabPool
+    {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "SlabPool only supports trivially destructible types");
+
+    public:
+        using Handle = uint32_t;
+        static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+        static constexpr size_t CHUNK_SHIFT = ChunkShift;
+        static constexpr size_t CHUNK_SIZE = size_t{1} << ChunkShift;
+
+    private:
+        static constexpr size_t CHUNK_MASK = CHUNK_SIZE - 1;
+
+        union Slot
+        {
+            Handle next_free;
+            T value;
+
+            Slot() noexcept : next_free(INVALID_HANDLE) {}
+        };
+
+        std::vector<std::unique_ptr<Slot[]>> chunks_;
+        Handle free_head_{INVALID_HANDLE};
+        size_t in_use_{0};
+        size_t high_water_{0};
+
+        Slot &slot(Handle handle) noexcept
+        {
+            return chunks_[handle >> CHUNK_SHIFT][handle & CHUNK_MASK];
+        }
+
+        const Slot &slot(Handle handle) const noexcept
+        {
+            return chunks_[handle >> CHUNK_SHIFT][handle & CHUNK_MASK];
+        }
+
+        // Allocate one more chunk and thread its slots onto the free list
+        void grow()
+        {
+            const auto base = static_cast<Handle>(chunks_.size() * CHUNK_SIZE);
+            chunks_.push_back(std::make_unique<Slot[]>(CHUNK_SIZE));
+
+            Slot *chunk = chunks_.back().get();
+            for (size_t i = 0; i < CHUNK_SIZE - 1; ++i)
+            {
+                chunk[i].next_free = base + static_cast<Handle>(i + 1);
+            }
+            chunk[CHUNK_SIZE - 1].next_free = free_head_;
+            free_head_ = base;
+        }
+
+    public:
+        explicit SlabPool(size_t initial_capacity = CHUNK_SIZE)
+        {
+            reserve(initial_capacity);
+        }
+
+        // Delete copy operations
+        SlabPool(const SlabPool &) = delete;
+        SlabPool &operator=(const SlabPool &) = delete;
+
+        /**
+         * Make sure at least `capacity` slots are owned by the pool
+         */
+        void reserve(size_t capacity)
+        {
+            while (chunks_.size() * CHUNK_SIZE < capacity)
+            {
+                grow();
+            }
+        }
+
+        /**
+         * Construct an object in a free slot, growing by one chunk if needed
+         * @return Handle of the new object
+         */
+        template <typename... Args>
+        Handle allocate(Args &&...args)
+        {
+            if (free_head_ == INVALID_HANDLE)
+            {
+                grow();
+            }
+
+            const Handle handle = free_head_;
+            Slot &s = slot(handle);
+            free_head_ = s.next_free;
+            ::new (&s.value) T(std::forward<Args>(args)...);
+
+            if (++in_use_ > high_water_)
+            {
+                high_water_ = in_use_;
+            }
+            return handle;
+        }
+
+        /**
+         * Return a slot to the free list
+         */
+        void release(Handle handle) noexcept
+        {
+            Slot &s = slot(handle);
+            s.next_free = free_head_;
+            free_head_ = handle;
+            --in_use_;
+        }
+
+        /**
+         * Release every slot at once without visiting live objects
+         *
+         * Rebuilds the free list in handle order; capacity and high-water
+         * mark are preserved.
+         */
+        void reset() noexcept
+        {
+            free_head_ = INVALID_HANDLE;
+            for (size_t c = chunks_.size(); c-- > 0;)
+            {
+                Slot *chunk = chunks_[c].get();
+                const auto base = static_cast<Handle>(c * CHUNK_SIZE);
+                for (size_t i = CHUNK_SIZE; i-- > 0;)
+                {
+                    chunk[i].next_free = free_head_;
+                    free_head_ = base + static_cast<Handle>(i);
+                }
+            }
+            in_use_ = 0;
+        }
+
+        T &operator[](Handle handle) noexcept
+        {
+            return slot(handle).value;
+        }
+
+        const T &operator[](Handle handle) const noexcept
+        {
+            return slot(handle).value;
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return chunks_.size() * CHUNK_SIZE;
+        }
+
+        [[nodiscard]] size_t in_use() const noexcept
+        {
+            return in_use_;
+        }
+
+        [[nodiscard]] PoolStats stats() const noexcept
+        {
+            PoolStats s;
+            s.capacity = capacity();
+            s.in_use = in_use_;
+            s.high_water = high_water_;
+            s.chunks = chunks_.size();
+            return s;
+        }
+    };
+
+    /**
+     * Side array addressed by SlabPool handles
+     *
+     * Holds a second, independently laid out object per pool slot, using the
+     * same chunk geometry so a handle indexes both. This lets a hot record
+     * live in the pool while rarely used fields sit in a parallel column
+     * that is only touched when needed.
+     *
+     * @tparam T Element type (default constructible)
+     * @tparam ChunkShift Must match the companion pool's ChunkShift
+     */
+    template <typename T, size_t ChunkShift = 8>
+    class SlabColumn
+    {
+    public:
+        using Handle = uint32_t;
+        static constexpr size_t CHUNK_SIZE = size_t{1} << ChunkShift;
+
+    private:
+        static constexpr size_t CHUNK_MASK = CHUNK_SIZE - 1;
+
+        std::vector<std::unique_ptr<T[]>> chunks_;
+
+    public:
+        SlabColumn() = default;
+
+        // Delete copy operations
+        SlabColumn(const SlabColumn &) = delete;
+        SlabColumn &operator=(const SlabColumn &) = delete;
+
+        /**
+         * Make sure every handle below `capacity` has an element
+         */
+        void reserve(size_t capacity)
+        {
+            while (chunks_.size() * CHUNK_SIZE < capacity)
+            {
+                chunks_.push_back(std::make_unique<T[]>(CHUNK_SIZE));
+            }
+        }
+
+        T &operator[](Handle handle) noexcept
+        {
+            return chunks_[handle >> ChunkShift][handle & CHUNK_MASK];
+        }
+
+        const T &operator[](Handle handle) const noexcept
+        {
+            return chunks_[handle >> ChunkShift][handle & CHUNK_MASK];
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return chunks_.size() * CHUNK_SIZE;
+        }
+    };
+
+} // namespace micromatch::utils
@@ -5,7 +5,9 @@
 #include <new>
 #include <optional>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <span>
 
 namespace micromatch::utils
 {
@@ -100,6 +102,118 @@ namespace micromatch::utils
             return true;
         }
 
+        /**
+         * Construct an item in a new node (producer only)
+         * @return true if successful
+         */
+        template <typename... Args>
+        bool emplace(Args &&...args)
+        {
+            Node *new_node = new Node(std::forward<Args>(args)...);
+            cached_tail_->next.store(new_node, std::memory_order_release);
+            cached_tail_ = new_node;
+            tail_.store(new_node, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Copy a run of items (producer only). The nodes are linked to each
+         * other first and then to the queue with a single release store.
+         * @return Number of items pushed (always all of them)
+         */
+        size_t try_push_n(std::span<const T> items)
+        {
+            if (items.empty())
+            {
+                return 0;
+            }
+            Node *first = new Node(items[0]);
+            Node *last = first;
+            for (size_t i = 1; i < items.size(); ++i)
+            {
+                Node *node = new Node(items[i]);
+                last->next.store(node, std::memory_order_relaxed);
+                last = node;
+            }
+            cached_tail_->next.store(first, std::memory_order_release);
+            cached_tail_ = last;
+            tail_.store(last, std::memory_order_release);
+            return items.size();
+        }
+
+        /**
+         * Same as enqueue(); the list is unbounded, so it never fails. Lets
+         * code written against the SPSCRing interface take either queue.
+         */
+        template <typename U>
+        bool try_push(U &&value)
+        {
+            return enqueue(std::forward<U>(value));
+        }
+
+        /**
+         * Dequeue into `out` (consumer only)
+         * @return false if the queue is empty
+         */
+        bool try_pop(T &out)
+        {
+            auto value = dequeue();
+            if (!value)
+            {
+                return false;
+            }
+            out = std::move(*value);
+            return true;
+        }
+
+        /**
+         * Move up to `max` of the oldest items into `out` (consumer only)
+         * @return Number of items popped
+         */
+        size_t pop_n(T *out, size_t max)
+        {
+            return consume([&out](T &item)
+                           { *out++ = std::move(item); },
+                           max);
+        }
+
+        /**
+         * Call fn(T&) on up to `max` of the oldest items in their nodes,
+         * then publish the new head once (consumer only)
+         * @return Number of items consumed
+         */
+        template <typename Fn>
+        size_t consume(Fn &&fn, size_t max = SIZE_MAX)
+        {
+            Node *head = cached_head_;
+            size_t count = 0;
+            while (count < max)
+            {
+                Node *next = head->next.load(std::memory_order_acquire);
+                if (next == nullptr)
+                {
+                    break;
+                }
+                fn(next->data);
+                head = next; // Becomes the dummy
+                ++count;
+            }
+            if (count > 0)
+            {
+                // Publish, then free the nodes that were passed over
+                Node *node = cached_head_;
+                head_.store(head, std::memory_order_release);
+                cached_head_ = head;
+                while (node != head)
+                {
+                    Node *next = node->next.load(std::memory_order_relaxed);
+                    delete node;
+                    node = next;
+                }
+            }
+            return count;
+        }
+
         /**
          * Try to dequeue an item (consumer only)
          * @return Optional containing the dequeued item if successful
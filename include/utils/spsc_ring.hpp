@@ -0,0 +1,270 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace micromatch::utils
+{
+
+    /**
+     * Bounded Single Producer Single Consumer ring buffer
+     *
+     * Elements live in one preallocated power-of-two array, so pushing and
+     * popping never allocate. Each side keeps a private copy of the other
+     * side's index and only reads the shared one when the ring looks full
+     * (producer) or empty (consumer), which keeps the two cache lines from
+     * bouncing while both sides are busy.
+     *
+     * With a non-zero Capacity the size is a compile-time constant, so the
+     * full check and the index mask fold to immediates; with the default
+     * of 0 the capacity is given to the constructor instead.
+     *
+     * The batch calls (try_push_n, pop_n, consume) move several items
+     * but publish the shared index once, so a burst costs one release
+     * store and one cross-core cache line transfer rather than one each.
+     *
+     * @tparam T Element type (default constructible, move assignable)
+     * @tparam Capacity Slots (power of 2), or 0 to size at construction
+     */
+    template <typename T, size_t Capacity = 0>
+    class SPSCRing
+    {
+        static_assert(Capacity == 0 || (Capacity >= 2 && (Capacity & (Capacity - 1)) == 0),
+                      "Capacity must be a power of 2");
+
+    private:
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+        static constexpr bool FIXED = Capacity != 0;
+
+        const size_t capacity_;
+        const size_t mask_;
+        std::unique_ptr<T[]> slots_;
+
+        // Producer side
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head_{0};
+        uint64_t cached_tail_{0};
+
+        // Consumer side
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail_{0};
+        uint64_t cached_head_{0};
+
+        static size_t round_up_pow2(size_t n)
+        {
+            size_t capacity = 2;
+            while (capacity < n)
+            {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+
+        // Items the producer can write without passing the consumer,
+        // refreshing its view of the tail only if that would limit `wanted`
+        size_t free_slots(uint64_t head, size_t wanted)
+        {
+            size_t free = capacity() - static_cast<size_t>(head - cached_tail_);
+            if (free < wanted)
+            {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                free = capacity() - static_cast<size_t>(head - cached_tail_);
+            }
+            return free;
+        }
+
+        // Items the consumer can read, refreshing its view of the head
+        // only if that would limit `wanted`
+        size_t ready_slots(uint64_t tail, size_t wanted)
+        {
+            size_t ready = static_cast<size_t>(cached_head_ - tail);
+            if (ready < wanted)
+            {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                ready = static_cast<size_t>(cached_head_ - tail);
+            }
+            return ready;
+        }
+
+        size_t mask() const noexcept
+        {
+            if constexpr (FIXED)
+            {
+                return Capacity - 1;
+            }
+            else
+            {
+                return mask_;
+            }
+        }
+
+    public:
+        SPSCRing() requires FIXED
+            : capacity_(Capacity), mask_(Capacity - 1), slots_(std::make_unique<T[]>(Capacity)) {}
+
+        /**
+         * @param capacity Slots, rounded up to a power of two
+         */
+        explicit SPSCRing(size_t capacity) requires(!FIXED)
+            : capacity_(round_up_pow2(capacity)), mask_(capacity_ - 1),
+              slots_(std::make_unique<T[]>(capacity_)) {}
+
+        // Delete copy operations
+        SPSCRing(const SPSCRing &) = delete;
+        SPSCRing &operator=(const SPSCRing &) = delete;
+
+        /**
+         * Push an item if there is room (producer only)
+         * @return false if the ring is full
+         */
+        template <typename U>
+        bool try_push(U &&value)
+        {
+            const uint64_t head = head_.load(std::memory_order_relaxed);
+            if (head - cached_tail_ == capacity())
+            {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (head - cached_tail_ == capacity())
+                {
+                    return false;
+                }
+            }
+            slots_[head & mask()] = std::forward<U>(value);
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Construct an item in its slot if there is room (producer only)
+         * @return false if the ring is full
+         */
+        template <typename... Args>
+        bool emplace(Args &&...args)
+        {
+            const uint64_t head = head_.load(std::memory_order_relaxed);
+            if (free_slots(head, 1) == 0)
+            {
+                return false;
+            }
+            T &slot = slots_[head & mask()];
+            if constexpr (std::is_nothrow_constructible_v<T, Args...>)
+            {
+                std::destroy_at(&slot);
+                std::construct_at(&slot, std::forward<Args>(args)...);
+            }
+            else
+            {
+                slot = T(std::forward<Args>(args)...);
+            }
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Copy as many leading items as fit (producer only)
+         * @return Number of items pushed
+         */
+        size_t try_push_n(std::span<const T> items)
+        {
+            const uint64_t head = head_.load(std::memory_order_relaxed);
+            const size_t count = std::min(items.size(), free_slots(head, items.size()));
+            for (size_t i = 0; i < count; ++i)
+            {
+                slots_[(head + i) & mask()] = items[i];
+            }
+            if (count > 0)
+            {
+                head_.store(head + count, std::memory_order_release);
+            }
+            return count;
+        }
+
+        /**
+         * Pop the oldest item into `out` if there is one (consumer only)
+         * @return false if the ring is empty
+         */
+        bool try_pop(T &out)
+        {
+            const uint64_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == cached_head_)
+            {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail == cached_head_)
+                {
+                    return false;
+                }
+            }
+            out = std::move(slots_[tail & mask()]);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Move up to `max` of the oldest items into `out` (consumer only)
+         * @return Number of items popped
+         */
+        size_t pop_n(T *out, size_t max)
+        {
+            return consume([&out](T &item)
+                           { *out++ = std::move(item); },
+                           max);
+        }
+
+        /**
+         * Call fn(T&) on up to `max` of the oldest items where they lie in
+         * the ring, then release their slots together (consumer only). The
+         * producer cannot reuse a slot until consume() returns.
+         * @return Number of items consumed
+         */
+        template <typename Fn>
+        size_t consume(Fn &&fn, size_t max = SIZE_MAX)
+        {
+            const uint64_t tail = tail_.load(std::memory_order_relaxed);
+            const size_t count = std::min(max, ready_slots(tail, max));
+            for (size_t i = 0; i < count; ++i)
+            {
+                fn(slots_[(tail + i) & mask()]);
+            }
+            if (count > 0)
+            {
+                tail_.store(tail + count, std::memory_order_release);
+            }
+            return count;
+        }
+
+        /**
+         * Check if the ring is empty (consumer only)
+         */
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return tail_.load(std::memory_order_relaxed) == head_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Approximate number of items (exact when called from either side
+         * while the other is idle)
+         */
+        [[nodiscard]] size_t size_approx() const noexcept
+        {
+            return static_cast<size_t>(head_.load(std::memory_order_acquire) -
+                                       tail_.load(std::memory_order_acquire));
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            if constexpr (FIXED)
+            {
+                return Capacity;
+            }
+            else
+            {
+                return capacity_;
+            }
+        }
+    };
+
+} // namespace micromatch::utils
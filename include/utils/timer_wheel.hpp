@@ -0,0 +1,257 @@
+#pragma once
+
+#include "utils/slab_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace micromatch::utils
+{
+
+    /**
+     * Hierarchical timing wheel for timers keyed by SlabPool handles
+     *
+     * Four levels of 64 slots; a level-n slot spans 64^n ticks, so the wheel
+     * reaches 64^4 ticks ahead (about 4.6 hours at 1ms per tick). Later
+     * deadlines are parked in the farthest slot and re-filed once time
+     * catches up. Each timer is an intrusive list node in a per-handle
+     * column, so schedule() and cancel() are O(1). advance() fires the
+     * level-0 slot of every tick it passes and cascades a higher-level slot
+     * down when its span begins; stretches with no timers in the lower
+     * levels are skipped a whole span at a time.
+     *
+     * A timer fires on the first advance() whose tick covers its deadline,
+     * i.e. never early and at most one tick late.
+     */
+    class TimerWheel
+    {
+    public:
+        using Handle = uint32_t;
+
+    private:
+        static constexpr size_t SLOT_BITS = 6;
+        static constexpr size_t SLOTS = size_t{1} << SLOT_BITS;
+        static constexpr size_t SLOT_MASK = SLOTS - 1;
+        static constexpr size_t LEVELS = 4;
+        static constexpr uint64_t HORIZON = uint64_t{1} << (SLOT_BITS * LEVELS);
+        static constexpr Handle NIL = UINT32_MAX;
+        static constexpr uint16_t UNSCHEDULED = UINT16_MAX;
+
+        struct Entry
+        {
+            uint64_t tick{0};
+            uint64_t tag{0};
+            Handle prev{NIL};
+            Handle next{NIL};
+            uint16_t slot{UNSCHEDULED}; // level * SLOTS + index
+        };
+
+        SlabColumn<Entry> entries_;
+        std::array<Handle, LEVELS * SLOTS> heads_;
+        std::array<size_t, LEVELS> level_size_{};
+        uint64_t tick_ns_;
+        uint64_t now_tick_{0}; // Next tick to fire
+        size_t size_{0};
+
+        static constexpr uint64_t span(size_t level)
+        {
+            return uint64_t{1} << (SLOT_BITS * level);
+        }
+
+        void link(Handle handle, uint16_t slot) noexcept
+        {
+            Entry &entry = entries_[handle];
+            entry.slot = slot;
+            entry.prev = NIL;
+            entry.next = heads_[slot];
+            if (entry.next != NIL)
+            {
+                entries_[entry.next].prev = handle;
+            }
+            heads_[slot] = handle;
+            ++level_size_[slot / SLOTS];
+            ++size_;
+        }
+
+        void unlink(Handle handle) noexcept
+        {
+            Entry &entry = entries_[handle];
+            if (entry.prev != NIL)
+            {
+                entries_[entry.prev].next = entry.next;
+            }
+            else
+            {
+                heads_[entry.slot] = entry.next;
+            }
+            if (entry.next != NIL)
+            {
+                entries_[entry.next].prev = entry.prev;
+            }
+            --level_size_[entry.slot / SLOTS];
+            --size_;
+            entry.slot = UNSCHEDULED;
+        }
+
+        // Put a timer in the slot for its tick relative to now_tick_
+        void file(Handle handle) noexcept
+        {
+            uint64_t tick = std::max(entries_[handle].tick, now_tick_);
+            if (tick - now_tick_ >= HORIZON)
+            {
+                tick = now_tick_ + HORIZON - 1; // Re-filed when the far slot cascades
+            }
+
+            size_t level = 0;
+            while (level + 1 < LEVELS && tick - now_tick_ >= span(level + 1))
+            {
+                ++level;
+            }
+            const size_t index = (tick >> (SLOT_BITS * level)) & SLOT_MASK;
+            link(handle, static_cast<uint16_t>(level * SLOTS + index));
+        }
+
+        // Re-file the slots whose span starts at now_tick_, highest first
+        void cascade() noexcept
+        {
+            for (size_t level = LEVELS - 1; level > 0; --level)
+            {
+                if ((now_tick_ & (span(level) - 1)) != 0)
+                {
+                    continue;
+                }
+                const size_t slot = level * SLOTS + ((now_tick_ >> (SLOT_BITS * level)) & SLOT_MASK);
+                while (heads_[slot] != NIL)
+                {
+                    const Handle handle = heads_[slot];
+                    unlink(handle);
+                    file(handle);
+                }
+            }
+        }
+
+    public:
+        explicit TimerWheel(uint64_t tick_ns = 1'000'000) : tick_ns_(tick_ns)
+        {
+            heads_.fill(NIL);
+        }
+
+        // Delete copy operations
+        TimerWheel(const TimerWheel &) = delete;
+        TimerWheel &operator=(const TimerWheel &) = delete;
+
+        /**
+         * Make sure every handle below `capacity` can carry a timer
+         */
+        void reserve(size_t capacity)
+        {
+            entries_.reserve(capacity);
+        }
+
+        /**
+         * Arm the timer for `handle`, replacing any timer it already has
+         * @param tag Passed back to the advance() callback
+         */
+        void schedule(Handle handle, uint64_t deadline_ns, uint64_t tag) noexcept
+        {
+            if (entries_[handle].slot != UNSCHEDULED)
+            {
+                unlink(handle);
+            }
+            Entry &entry = entries_[handle];
+            entry.tick = (deadline_ns + tick_ns_ - 1) / tick_ns_;
+            entry.tag = tag;
+            file(handle);
+        }
+
+        /**
+         * Disarm the timer for `handle`
+         * @return false if it had none
+         */
+        bool cancel(Handle handle) noexcept
+        {
+            if (entries_[handle].slot == UNSCHEDULED)
+            {
+                return false;
+            }
+            unlink(handle);
+            return true;
+        }
+
+        [[nodiscard]] bool scheduled(Handle handle) const noexcept
+        {
+            return entries_[handle].slot != UNSCHEDULED;
+        }
+
+        /**
+         * Fire every timer due by `now_ns` as fn(handle, tag)
+         *
+         * A timer is disarmed before its callback runs, and the callback may
+         * schedule or cancel other timers.
+         * @return Number of timers fired
+         */
+        template <typename Fn>
+        size_t advance(uint64_t now_ns, Fn &&fn)
+        {
+            const uint64_t target = now_ns / tick_ns_;
+            size_t fired = 0;
+
+            while (now_tick_ <= target)
+            {
+                if (size_ == 0)
+                {
+                    now_tick_ = target + 1;
+                    break;
+                }
+
+                cascade();
+                const size_t slot = now_tick_ & SLOT_MASK;
+                while (heads_[slot] != NIL)
+                {
+                    const Handle handle = heads_[slot];
+                    const uint64_t tag = entries_[handle].tag;
+                    unlink(handle);
+                    fn(handle, tag);
+                    ++fired;
+                }
+
+                // Jump to the next point where the lowest occupied level
+                // has work: the next tick, or the start of its next span
+                size_t level = 0;
+                while (level < LEVELS && level_size_[level] == 0)
+                {
+                    ++level;
+                }
+                if (level == 0 || level == LEVELS)
+                {
+                    ++now_tick_;
+                }
+                else
+                {
+                    const uint64_t next = (now_tick_ | (span(level) - 1)) + 1;
+                    now_tick_ = std::min(next, target + 1);
+                }
+            }
+            return fired;
+        }
+
+        /**
+         * Disarm every timer
+         */
+        void clear() noexcept
+        {
+            for (size_t slot = 0; slot < heads_.size(); ++slot)
+            {
+                while (heads_[slot] != NIL)
+                {
+                    unlink(heads_[slot]);
+                }
+            }
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    };
+
+} // namespace micromatch::utils
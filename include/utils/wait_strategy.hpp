@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <thread>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace micromatch::utils
+{
+
+    /**
+     * How a consumer thread waits when it finds no work
+     */
+    enum class WaitStrategy : uint8_t
+    {
+        SLEEP = 0,      // Fixed 10µs sleep per empty poll
+        BUSY_SPIN = 1,  // Poll continuously with a pause hint; owns a core
+        SPIN_YIELD = 2, // Spin briefly, then yield the core between polls
+        SPIN_PARK = 3   // Spin briefly, then sleep in the kernel until a producer wakes it
+    };
+
+    /**
+     * CPU hint that the caller is in a spin-wait loop
+     */
+    inline void cpu_relax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    /**
+     * Idle policy shared by one consumer and its producers
+     *
+     * The consumer calls idle() each time a poll comes back empty and
+     * reset() once it finds work again; the escalation from spinning to
+     * yielding or parking restarts after every reset(). Producers call
+     * notify() after publishing work, which under SPIN_PARK wakes a parked
+     * consumer with a futex. A producer only pays for the wake-up syscall
+     * when the consumer is actually parked; otherwise notify() is a fence
+     * and a load.
+     *
+     * On a single CPU there is nobody to spin for: the producer cannot run
+     * while the consumer holds the core, so the spin phase is skipped.
+     *
+     * Parking uses the usual flag-then-recheck handshake: the consumer
+     * announces it is about to park, then re-checks for work, while a
+     * producer publishes and then checks the flag. With a full fence on
+     * both sides, one of the two always sees the other, so a wake-up is
+     * never lost.
+     */
+    class IdleWaiter
+    {
+    private:
+        static constexpr uint32_t SPIN_LIMIT = 2048;
+
+        const WaitStrategy strategy_;
+        const uint32_t spin_limit_;
+        uint32_t spins_{0}; // Consumer only
+
+        alignas(64) std::atomic<uint32_t> epoch_{0};
+        std::atomic<uint32_t> parked_{0};
+
+        void park(uint32_t epoch, std::chrono::nanoseconds timeout) noexcept
+        {
+            const auto ns = timeout.count();
+            timespec ts{static_cast<time_t>(ns / 1'000'000'000), static_cast<long>(ns % 1'000'000'000)};
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_), FUTEX_WAIT_PRIVATE, epoch, &ts,
+                      nullptr, 0);
+        }
+
+    public:
+        explicit IdleWaiter(WaitStrategy strategy = WaitStrategy::SLEEP) noexcept
+            : strategy_(strategy), spin_limit_(std::thread::hardware_concurrency() > 1 ? SPIN_LIMIT : 0) {}
+
+        // Delete copy operations
+        IdleWaiter(const IdleWaiter &) = delete;
+        IdleWaiter &operator=(const IdleWaiter &) = delete;
+
+        [[nodiscard]] WaitStrategy strategy() const noexcept { return strategy_; }
+
+        /**
+         * Consumer found work: start the next idle stretch from spinning
+         */
+        void reset() noexcept
+        {
+            spins_ = 0;
+        }
+
+        /**
+         * Consumer found no work: wait according to the strategy
+         * @param has_work Re-checks for work just before parking
+         * @param max_park Longest a park may last, so the consumer still
+         *                 runs its timers (and sees a stop request) on time
+         */
+        template <typename HasWork>
+        void idle(HasWork &&has_work, std::chrono::nanoseconds max_park) noexcept
+        {
+            switch (strategy_)
+            {
+            case WaitStrategy::BUSY_SPIN:
+                cpu_relax();
+                return;
+
+            case WaitStrategy::SPIN_YIELD:
+                if (spins_ < spin_limit_)
+                {
+                    ++spins_;
+                    cpu_relax();
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+                return;
+
+            case WaitStrategy::SPIN_PARK:
+                if (spins_ < spin_limit_)
+                {
+                    ++spins_;
+                    cpu_relax();
+                    return;
+                }
+                {
+                    const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+                    parked_.store(1, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (!has_work())
+                    {
+                        park(epoch, max_park);
+                    }
+                    parked_.store(0, std::memory_order_relaxed);
+                }
+                return;
+
+            case WaitStrategy::SLEEP:
+            default:
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+                return;
+            }
+        }
+
+        /**
+         * Producer published work: wake the consumer if it is parked
+         */
+        void notify() noexcept
+        {
+            if (strategy_ != WaitStrategy::SPIN_PARK)
+            {
+                return;
+            }
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (parked_.load(std::memory_order_relaxed) != 0)
+            {
+                epoch_.fetch_add(1, std::memory_order_release);
+                ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_), FUTEX_WAKE_PRIVATE, 1, nullptr,
+                          nullptr, 0);
+            }
+        }
+
+        /**
+         * Wake the consumer regardless of the flag, e.g. to stop it
+         */
+        void wake() noexcept
+        {
+            epoch_.fetch_add(1, std::memory_order_release);
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_), FUTEX_WAKE_PRIVATE, 1, nullptr,
+                      nullptr, 0);
+        }
+    };
+
+    /**
+     * Futex-backed event count: lets any number of threads sleep until a
+     * lock-free structure changes, without a mutex on the fast path
+     *
+     * A waiter calls prepare_wait(), re-tries its operation, and only then
+     * either cancel_wait()s (it succeeded) or wait()s with the returned
+     * key. A notifier changes the structure and then calls notify(). The
+     * waiter registers before re-trying and the notifier checks for
+     * waiters after changing, each behind a full fence, so either the
+     * re-try sees the change or the notifier sees the waiter; and a
+     * notify between prepare_wait() and wait() moves the key on, so wait()
+     * returns at once. notify() costs a fence and a load unless somebody
+     * is registered.
+     */
+    class EventCount
+    {
+    private:
+        alignas(64) std::atomic<uint32_t> epoch_{0};
+        std::atomic<uint32_t> waiters_{0};
+
+    public:
+        EventCount() = default;
+
+        // Delete copy operations
+        EventCount(const EventCount &) = delete;
+        EventCount &operator=(const EventCount &) = delete;
+
+        /**
+         * Register as a waiter; re-try the operation after this
+         * @return Key for wait()
+         */
+        uint32_t prepare_wait() noexcept
+        {
+            const uint32_t key = epoch_.load(std::memory_order_acquire);
+            waiters_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return key;
+        }
+
+        /**
+         * Withdraw after prepare_wait() when the re-try succeeded
+         */
+        void cancel_wait() noexcept
+        {
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * Sleep until a notify() after prepare_wait() or until the timeout,
+         * then withdraw. Wake-ups may be spurious; re-try and wait again.
+         */
+        void wait(uint32_t key, std::chrono::nanoseconds timeout) noexcept
+        {
+            const auto ns = timeout.count();
+            timespec ts{static_cast<time_t>(ns / 1'000'000'000), static_cast<long>(ns % 1'000'000'000)};
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_), FUTEX_WAIT_PRIVATE, key, &ts,
+                      nullptr, 0);
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * Wake up to `count` waiters if any are registered
+         */
+        void notify(uint32_t count = 1) noexcept
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters_.load(std::memory_order_relaxed) != 0)
+            {
+                epoch_.fetch_add(1, std::memory_order_release);
+                ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_), FUTEX_WAKE_PRIVATE,
+                          static_cast<int>(std::min<uint32_t>(count, INT_MAX)), nullptr, nullptr, 0);
+            }
+        }
+    };
+
+} // namespace micromatch::utils
@@ -0,0 +1,346 @@
+#include "core/journal.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace micromatch::core
+{
+
+    class JournalImpl : public IJournal
+    {
+    private:
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+
+        const DurabilityPolicy durability_;
+        const size_t max_batch_;
+        int fd_;
+        uint64_t last_sequence_;
+
+        // Journal thread: end of the last whole record in the file
+        off_t end_;
+
+        // Single-producer single-consumer ring of records. The journal
+        // thread writes runs straight out of the ring, so a record is
+        // copied once on append and never again before it reaches the file.
+        const size_t capacity_;
+        const size_t mask_;
+        std::unique_ptr<JournalRecord[]> ring_;
+
+        // Producer side: records published, and its last view of the
+        // consumer position so the shared counter is read only when the
+        // ring looks full
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head_{0};
+        alignas(CACHE_LINE_SIZE) uint64_t cached_tail_{0};
+        std::vector<JournalRecord> backlog_;
+        size_t backlog_front_{0};
+
+        // Consumer side: records written
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail_{0};
+        std::atomic<uint64_t> durable_sequence_{0};
+
+        std::atomic<uint64_t> records_{0};
+        std::atomic<uint64_t> batches_{0};
+        std::atomic<uint64_t> syncs_{0};
+        std::atomic<uint64_t> backlogged_{0};
+        std::atomic<uint64_t> write_errors_{0};
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<bool> failed_{false};
+
+        std::atomic<bool> running_{true};
+        std::thread writer_;
+
+        static size_t round_up_pow2(size_t n)
+        {
+            size_t capacity = 2;
+            while (capacity < n)
+            {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+
+        // Copy a record into the ring if there is room
+        bool try_push(const JournalRecord &record)
+        {
+            const uint64_t head = head_.load(std::memory_order_relaxed);
+            if (head - cached_tail_ == capacity_)
+            {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (head - cached_tail_ == capacity_)
+                {
+                    return false;
+                }
+            }
+            ring_[head & mask_] = record;
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Write a run at end_; on failure cut off whatever part of it landed
+        bool write_all(const JournalRecord *records, size_t count)
+        {
+            auto *bytes = reinterpret_cast<const char *>(records);
+            size_t remaining = count * sizeof(JournalRecord);
+            off_t offset = end_;
+            while (remaining > 0)
+            {
+                const ssize_t written = ::pwrite(fd_, bytes, remaining, offset);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (offset != end_ && ::ftruncate(fd_, end_) != 0)
+                    {
+                        // Still only in-order records; open_journal() drops the torn tail
+                    }
+                    return false;
+                }
+                bytes += written;
+                offset += written;
+                remaining -= static_cast<size_t>(written);
+            }
+            end_ = offset;
+            return true;
+        }
+
+        bool sync()
+        {
+            syncs_.fetch_add(1, std::memory_order_relaxed);
+            return ::fdatasync(fd_) == 0;
+        }
+
+        void fail()
+        {
+            write_errors_.fetch_add(1, std::memory_order_relaxed);
+            failed_.store(true, std::memory_order_release);
+        }
+
+        // Journal thread: write whatever has been published as contiguous
+        // runs of the ring. A run is everything available up to max_batch
+        // or the end of the ring, so a burst costs one write() (and, for
+        // PER_BATCH, one fdatasync) however many records it holds.
+        void writer_loop()
+        {
+            uint64_t tail = tail_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                const uint64_t head = head_.load(std::memory_order_acquire);
+                if (head == tail)
+                {
+                    if (!running_.load(std::memory_order_acquire))
+                    {
+                        return;
+                    }
+                    std::this_thread::sleep_for(std::chrono::microseconds(10));
+                    continue;
+                }
+
+                const size_t offset = tail & mask_;
+                size_t count = std::min<size_t>({head - tail, max_batch_, capacity_ - offset});
+                if (durability_ == DurabilityPolicy::PER_MESSAGE)
+                {
+                    count = 1;
+                }
+
+                // After a failure, keep consuming so the producer never
+                // stalls, but write nothing: a later record must not land
+                // after a gap and make the lost ones look durable
+                if (failed_.load(std::memory_order_relaxed))
+                {
+                    dropped_.fetch_add(count, std::memory_order_relaxed);
+                }
+                else if (!write_all(&ring_[offset], count))
+                {
+                    fail();
+                    dropped_.fetch_add(count, std::memory_order_relaxed);
+                }
+                else
+                {
+                    batches_.fetch_add(1, std::memory_order_relaxed);
+                    records_.fetch_add(count, std::memory_order_relaxed);
+                    if (durability_ == DurabilityPolicy::ASYNC || sync())
+                    {
+                        durable_sequence_.store(ring_[offset + count - 1].sequence, std::memory_order_release);
+                    }
+                    else
+                    {
+                        fail();
+                    }
+                }
+
+                tail += count;
+                tail_.store(tail, std::memory_order_release);
+            }
+        }
+
+    public:
+        JournalImpl(const JournalConfig &config, int fd, uint64_t last_sequence, off_t end)
+            : durability_(config.durability),
+              max_batch_(std::max<size_t>(config.max_batch, 1)),
+              fd_(fd),
+              last_sequence_(last_sequence),
+              end_(end),
+              capacity_(round_up_pow2(config.ring_capacity)),
+              mask_(capacity_ - 1),
+              ring_(std::make_unique<JournalRecord[]>(capacity_))
+        {
+            durable_sequence_.store(last_sequence, std::memory_order_relaxed);
+            writer_ = std::thread(&JournalImpl::writer_loop, this);
+        }
+
+        ~JournalImpl()
+        {
+            flush();
+            running_.store(false, std::memory_order_release);
+            writer_.join();
+            ::close(fd_);
+        }
+
+        // Delete copy operations
+        JournalImpl(const JournalImpl &) = delete;
+        JournalImpl &operator=(const JournalImpl &) = delete;
+
+        void append(const JournalRecord &record) override
+        {
+            if (backlog_front_ < backlog_.size())
+            {
+                drain_backlog();
+            }
+            if (backlog_front_ < backlog_.size() || !try_push(record))
+            {
+                backlog_.push_back(record);
+                backlogged_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void drain_backlog() override
+        {
+            while (backlog_front_ < backlog_.size() && try_push(backlog_[backlog_front_]))
+            {
+                ++backlog_front_;
+            }
+            if (backlog_front_ == backlog_.size())
+            {
+                backlog_.clear();
+                backlog_front_ = 0;
+            }
+        }
+
+        void flush() override
+        {
+            for (;;)
+            {
+                drain_backlog();
+                if (backlog_.empty() &&
+                    tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_relaxed))
+                {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+            if (!failed_.load(std::memory_order_acquire) && !sync())
+            {
+                fail();
+            }
+        }
+
+        uint64_t durable_sequence() const override
+        {
+            return durable_sequence_.load(std::memory_order_acquire);
+        }
+
+        uint64_t last_sequence() const override
+        {
+            return last_sequence_;
+        }
+
+        bool failed() const override
+        {
+            return failed_.load(std::memory_order_acquire);
+        }
+
+        JournalStats stats() const override
+        {
+            JournalStats s;
+            s.records = records_.load(std::memory_order_relaxed);
+            s.batches = batches_.load(std::memory_order_relaxed);
+            s.syncs = syncs_.load(std::memory_order_relaxed);
+            s.backlogged = backlogged_.load(std::memory_order_relaxed);
+            s.write_errors = write_errors_.load(std::memory_order_relaxed);
+            s.dropped = dropped_.load(std::memory_order_relaxed);
+            return s;
+        }
+    };
+
+    std::unique_ptr<IJournal> open_journal(const JournalConfig &config)
+    {
+        const int fd = ::open(config.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            return nullptr;
+        }
+        auto size = static_cast<size_t>(info.st_size);
+
+        uint64_t last_sequence = 0;
+        if (size == 0)
+        {
+            const JournalFileHeader header;
+            if (::write(fd, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header)))
+            {
+                ::close(fd);
+                return nullptr;
+            }
+            size = sizeof(header);
+        }
+        else
+        {
+            JournalFileHeader header;
+            if (size < sizeof(header) ||
+                ::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+                header.magic != JournalFileHeader::MAGIC || header.record_size != sizeof(JournalRecord))
+            {
+                ::close(fd);
+                return nullptr; // Not a journal
+            }
+
+            // Drop a record torn by a crash mid-write, then continue the
+            // sequence from the last whole record
+            const size_t whole = size - (size - sizeof(header)) % sizeof(JournalRecord);
+            if (whole != size && ::ftruncate(fd, static_cast<off_t>(whole)) != 0)
+            {
+                ::close(fd);
+                return nullptr;
+            }
+            size = whole;
+            if (size > sizeof(header))
+            {
+                JournalRecord last;
+                if (::pread(fd, &last, sizeof(last), static_cast<off_t>(size - sizeof(last))) !=
+                    static_cast<ssize_t>(sizeof(last)))
+                {
+                    ::close(fd);
+                    return nullptr;
+                }
+                last_sequence = last.sequence;
+            }
+        }
+
+        return std::make_unique<JournalImpl>(config, fd, last_sequence, static_cast<off_t>(size));
+    }
+
+} // namespace micromatch::core
@@ -1,4 +1,12 @@
 #include "core/matching_engine.hpp"
+#include "utils/mapped_file.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <array>
+#include <bit>
+#include <mutex>
+#include <unordered_set>
 #include <thread>
 #include <chrono>
 #include <iostream>
@@ -6,14 +14,335 @@
 namespace micromatch::core
 {
 
+    // Engine checkpoint file: this header, each book's own image back to
+    // back, then a directory locating every image so books can be restored
+    // independently
+    struct EngineCheckpointHeader
+    {
+        static constexpr uint64_t MAGIC = 0x31544B43454D4D4Dull; // "MMMECKT1"
+
+        uint64_t magic{MAGIC};
+        uint64_t book_count{0};
+        uint64_t directory_offset{0};
+    };
+
+    struct EngineCheckpointEntry
+    {
+        uint64_t symbol_id{0};
+        uint64_t offset{0};
+        uint64_t size{0};
+    };
+
+    static constexpr size_t CHECKPOINT_BUFFER = 1 << 20;
+
+    // Write `books` to an engine checkpoint file at `path`
+    static bool write_engine_checkpoint(const std::string &path, const std::vector<const IOrderBook *> &books)
+    {
+        std::vector<char> buffer(CHECKPOINT_BUFFER);
+        std::ofstream out;
+        out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.open(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        EngineCheckpointHeader header;
+        header.book_count = books.size();
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        std::vector<EngineCheckpointEntry> directory;
+        directory.reserve(books.size());
+        for (const IOrderBook *book : books)
+        {
+            EngineCheckpointEntry entry;
+            entry.symbol_id = book->symbol_id();
+            entry.offset = static_cast<uint64_t>(out.tellp());
+            book->write_checkpoint(out);
+            entry.size = static_cast<uint64_t>(out.tellp()) - entry.offset;
+            directory.push_back(entry);
+        }
+
+        // Directory last, then point the header at it
+        header.directory_offset = static_cast<uint64_t>(out.tellp());
+        out.write(reinterpret_cast<const char *>(directory.data()),
+                  static_cast<std::streamsize>(directory.size() * sizeof(EngineCheckpointEntry)));
+        out.seekp(0);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.close();
+        return !out.fail();
+    }
+
+    // Rebuild every book in the engine checkpoint file at `path`
+    static bool read_engine_checkpoint(const std::string &path, const OrderBookConfig &config,
+                                       std::vector<std::unique_ptr<IOrderBook>> &books)
+    {
+        const utils::MappedFile file(path);
+        if (!file.is_open() || file.size() < sizeof(EngineCheckpointHeader))
+        {
+            return false;
+        }
+        EngineCheckpointHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (header.magic != EngineCheckpointHeader::MAGIC)
+        {
+            return false;
+        }
+
+        const size_t directory_bytes = file.size() - sizeof(header);
+        if (header.directory_offset < sizeof(header) ||
+            header.directory_offset > file.size() ||
+            header.book_count > directory_bytes / sizeof(EngineCheckpointEntry) ||
+            file.size() - header.directory_offset < header.book_count * sizeof(EngineCheckpointEntry))
+        {
+            return false;
+        }
+        std::vector<EngineCheckpointEntry> directory(header.book_count);
+        std::memcpy(directory.data(), file.data() + header.directory_offset,
+                    directory.size() * sizeof(EngineCheckpointEntry));
+        for (const auto &entry : directory)
+        {
+            if (entry.offset > header.directory_offset ||
+                entry.size > header.directory_offset - entry.offset)
+            {
+                return false;
+            }
+        }
+
+        // Images are independent, so books are rebuilt in parallel, each
+        // on the thread that will first touch its memory
+        std::vector<std::unique_ptr<IOrderBook>> restored(directory.size());
+        std::atomic<size_t> next_book{0};
+        std::atomic<bool> failed{false};
+        auto restore_books = [&]
+        {
+            for (size_t i = next_book++; i < directory.size() && !failed; i = next_book++)
+            {
+                const auto &entry = directory[i];
+                auto book = create_order_book(entry.symbol_id, config);
+                if (book->restore_checkpoint(file.data() + entry.offset, entry.size) != entry.size)
+                {
+                    failed = true;
+                    return;
+                }
+                restored[i] = std::move(book);
+            }
+        };
+        const size_t workers = std::min<size_t>(
+            directory.size(), std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < workers; ++t)
+        {
+            threads.emplace_back(restore_books);
+        }
+        restore_books();
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        if (failed)
+        {
+            return false;
+        }
+        books = std::move(restored);
+        return true;
+    }
+
+    static bool has_duplicate_symbols(const std::vector<std::unique_ptr<IOrderBook>> &books)
+    {
+        std::unordered_set<uint64_t> seen;
+        for (const auto &book : books)
+        {
+            if (!seen.insert(book->symbol_id()).second)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Per-thread ingress rings of one engine. A thread claims a slot on
+    // its first submit and retires it when it exits; the worker frees a
+    // retired slot once it has drained the ring, and the next new thread
+    // reuses it, ring and all. Slot states move FREE -> ACTIVE (under the
+    // mutex, by a producer), ACTIVE -> RETIRED (by the exiting producer)
+    // and RETIRED -> FREE (by the worker), each a release store read with
+    // acquire, so a ring's contents and indices pass cleanly from one
+    // owner to the next.
+    //
+    // Slots live in chunks that double in size and never move, so the
+    // table grows with the number of live producers while the worker
+    // keeps reading the slots it already knows about without a lock.
+    class IngressRegistry
+    {
+    public:
+        using Ring = utils::SPSCRing<OrderRequest>;
+
+        enum State : uint8_t
+        {
+            FREE = 0,
+            ACTIVE = 1,
+            RETIRED = 2
+        };
+
+        struct Slot
+        {
+            std::unique_ptr<Ring> ring;
+            std::atomic<uint8_t> state{FREE};
+        };
+
+        explicit IngressRegistry(size_t ring_capacity) : ring_capacity_(ring_capacity) {}
+
+        // Claim a slot for the calling thread, reusing a free one first
+        size_t acquire()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const size_t count = count_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < count; ++i)
+            {
+                Slot &slot = this->slot(i);
+                if (slot.state.load(std::memory_order_acquire) == FREE)
+                {
+                    slot.state.store(ACTIVE, std::memory_order_relaxed);
+                    return i;
+                }
+            }
+            const size_t chunk = chunk_of(count);
+            if (!chunks_[chunk])
+            {
+                chunks_[chunk] = std::make_unique<Slot[]>(FIRST_CHUNK << chunk);
+            }
+            Slot &slot = this->slot(count);
+            slot.ring = std::make_unique<Ring>(ring_capacity_);
+            slot.state.store(ACTIVE, std::memory_order_relaxed);
+            count_.store(count + 1, std::memory_order_release);
+            return count;
+        }
+
+        // The owning thread is exiting; whatever it queued is still applied
+        void retire(size_t index)
+        {
+            slot(index).state.store(RETIRED, std::memory_order_release);
+        }
+
+        // Slots ever created; the worker only looks at these
+        size_t count() const
+        {
+            return count_.load(std::memory_order_acquire);
+        }
+
+        Slot &slot(size_t index)
+        {
+            const size_t chunk = chunk_of(index);
+            return chunks_[chunk][index + FIRST_CHUNK - (FIRST_CHUNK << chunk)];
+        }
+
+        const Slot &slot(size_t index) const
+        {
+            const size_t chunk = chunk_of(index);
+            return chunks_[chunk][index + FIRST_CHUNK - (FIRST_CHUNK << chunk)];
+        }
+
+    private:
+        // Chunk k holds FIRST_CHUNK << k slots
+        static constexpr size_t FIRST_CHUNK = 64;
+        static constexpr size_t MAX_CHUNKS = 48;
+
+        static size_t chunk_of(size_t index)
+        {
+            return static_cast<size_t>(std::bit_width(index + FIRST_CHUNK)) -
+                   static_cast<size_t>(std::bit_width(FIRST_CHUNK));
+        }
+
+        const size_t ring_capacity_;
+        std::array<std::unique_ptr<Slot[]>, MAX_CHUNKS> chunks_;
+        std::atomic<size_t> count_{0};
+        std::mutex mutex_;
+    };
+
+    // The calling thread's ingress slots, one per engine it has submitted
+    // to. Engines are told by id, which is never reused; the registry is
+    // held weakly so that an engine destroyed first leaves nothing behind
+    // but an entry dropped at the thread's next registration.
+    class ProducerSlots
+    {
+    private:
+        struct Entry
+        {
+            uint64_t engine_id;
+            IngressRegistry::Ring *ring;
+            std::weak_ptr<IngressRegistry> registry;
+            size_t index;
+        };
+
+        std::vector<Entry> entries_;
+
+    public:
+        ~ProducerSlots()
+        {
+            for (const Entry &entry : entries_)
+            {
+                if (auto registry = entry.registry.lock())
+                {
+                    registry->retire(entry.index);
+                }
+            }
+        }
+
+        IngressRegistry::Ring &ring(uint64_t engine_id, const std::shared_ptr<IngressRegistry> &registry)
+        {
+            for (const Entry &entry : entries_)
+            {
+                if (entry.engine_id == engine_id)
+                {
+                    return *entry.ring;
+                }
+            }
+
+            std::erase_if(entries_, [](const Entry &entry)
+                          { return entry.registry.expired(); });
+            const size_t index = registry->acquire();
+            IngressRegistry::Ring *ring = registry->slot(index).ring.get();
+            entries_.push_back(Entry{engine_id, ring, registry, index});
+            return *ring;
+        }
+    };
+
     class MatchingEngineImpl : public IMatchingEngine
     {
     private:
+        static constexpr size_t TRADE_BUFFER_RESERVE = 1024;
+
+        // Requests taken off the queue between clock reads
+        static constexpr size_t BATCH_CLOCK_CHECK = 64;
+        static constexpr size_t EXPIRY_CLOCK_CHECK = 64;
+
+        // How often the worker sweeps books for expired GTD orders
+        static constexpr std::chrono::milliseconds EXPIRY_INTERVAL{1};
+
+        MatchingEngineConfig config_;
+
         // Order books by symbol ID
         std::unordered_map<uint64_t, std::unique_ptr<IOrderBook>> order_books_;
 
-        // Lock-free queue for order requests
-        utils::SPSCQueue<OrderRequest> order_queue_;
+        // Ingress: every thread that submits gets its own bounded SPSC
+        // ring the first time it does, so producers never contend with
+        // each other, and gives it back when it exits. The worker merges
+        // the rings round-robin, taking a short burst from each, which
+        // keeps every producer's requests in order and stops one busy
+        // producer from starving the rest.
+        using IngressRing = IngressRegistry::Ring;
+        static constexpr size_t INGRESS_BURST = 16;
+
+        std::shared_ptr<IngressRegistry> ingress_;
+        size_t ingress_cursor_{0}; // Worker only: next slot to drain
+
+        // Identifies the engine in each thread's slot list; never reused
+        inline static std::atomic<uint64_t> next_engine_id_{0};
+        const uint64_t engine_id_ = next_engine_id_.fetch_add(1, std::memory_order_relaxed);
+
+        // How the worker waits on an empty queue; submits wake it
+        utils::IdleWaiter idle_;
 
         // Callbacks
         TradeCallback trade_callback_;
@@ -22,10 +351,118 @@ namespace micromatch::core
         // Statistics
         mutable MatchingEngineStats stats_;
 
+        // Fill buffer reused for every order; only touched by the worker thread
+        std::vector<Trade> trade_buffer_;
+
+        // Batch auction mode: requests collected this interval, and the
+        // order to apply them in as (symbol, arrival index) keys. Both are
+        // reused across intervals; only touched by the worker thread.
+        std::vector<OrderRequest> batch_;
+        std::vector<std::pair<uint64_t, uint32_t>> batch_order_;
+
+        // Books whose last uncross triggered stops into the next auction;
+        // they are uncrossed at the next clear even if no request touches them
+        std::vector<uint64_t> held_stops_;
+        static constexpr uint32_t NO_REQUEST = UINT32_MAX;
+
+        // Next time the worker expires GTD orders
+        std::chrono::steady_clock::time_point next_expiry_{};
+
+        // Open while running with a journal configured; records are
+        // numbered by the worker, continuing from the file's last record
+        std::unique_ptr<IJournal> journal_;
+        uint64_t journal_sequence_{0};
+
+        // Time of the event being applied while journaling or replaying, 0
+        // otherwise. Books touched by the event have their clock pinned to
+        // it, so a trade carries the same timestamp live and on replay.
+        uint64_t event_ns_{0};
+
         // Engine state
         std::atomic<bool> running_{false};
         std::thread worker_thread_;
 
+        static uint64_t now_ns()
+        {
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        }
+
+        // Journal an engine event that carries no request
+        void journal(JournalEntry entry, uint64_t timestamp_ns)
+        {
+            JournalRecord record;
+            record.sequence = ++journal_sequence_;
+            record.timestamp_ns = timestamp_ns;
+            record.entry = entry;
+            journal_->append(record);
+        }
+
+        // Journal a request the worker is about to apply. Only the fields
+        // its type defines are copied; the others are left unset by the
+        // request factories.
+        void journal(const OrderRequest &request)
+        {
+            if (!journal_)
+            {
+                return;
+            }
+
+            JournalRecord record;
+            record.sequence = ++journal_sequence_;
+            record.timestamp_ns = event_ns_ = now_ns();
+            record.symbol_id = request_symbol(request);
+            switch (request.type)
+            {
+            case OrderRequest::NEW_ORDER:
+                record.entry = JournalEntry::NEW_ORDER;
+                record.order_id = request.order.order_id;
+                record.order = request.order;
+                break;
+            case OrderRequest::CANCEL_ORDER:
+                record.entry = JournalEntry::CANCEL_ORDER;
+                record.order_id = request.order_id;
+                break;
+            case OrderRequest::MODIFY_ORDER:
+                record.entry = JournalEntry::MODIFY_ORDER;
+                record.order_id = request.order_id;
+                record.new_price = request.new_price;
+                record.new_quantity = request.new_quantity;
+                break;
+            case OrderRequest::MASS_CANCEL:
+                record.entry = JournalEntry::MASS_CANCEL;
+                record.client_id = request.client_id;
+                record.has_side = request.side.has_value();
+                record.side = request.side.value_or(Side::BUY);
+                break;
+            case OrderRequest::PURGE_DAY:
+                record.entry = JournalEntry::PURGE_DAY;
+                break;
+            }
+            journal_->append(record);
+        }
+
+        // Rebuild the request a journal record describes
+        static OrderRequest journaled_request(const JournalRecord &record)
+        {
+            switch (record.entry)
+            {
+            case JournalEntry::CANCEL_ORDER:
+                return OrderRequest::cancel_order(record.symbol_id, record.order_id);
+            case JournalEntry::MODIFY_ORDER:
+                return OrderRequest::modify_order(record.symbol_id, record.order_id,
+                                                  record.new_price, record.new_quantity);
+            case JournalEntry::MASS_CANCEL:
+                return OrderRequest::mass_cancel(record.symbol_id, record.client_id,
+                                                 record.has_side ? std::optional<Side>(record.side)
+                                                                 : std::nullopt);
+            case JournalEntry::PURGE_DAY:
+                return OrderRequest::purge_day_orders();
+            case JournalEntry::NEW_ORDER:
+            default:
+                return OrderRequest::new_order(record.order);
+            }
+        }
+
         // Process a single order request
         void process_order_request(const OrderRequest &request)
         {
@@ -43,6 +480,14 @@ namespace micromatch::core
                 process_modify_order(request.symbol_id, request.order_id,
                                      request.new_price, request.new_quantity);
                 break;
+
+            case OrderRequest::MASS_CANCEL:
+                process_mass_cancel(request.symbol_id, request.client_id, request.side);
+                break;
+
+            case OrderRequest::PURGE_DAY:
+                process_purge_day(request.symbol_id);
+                break;
             }
         }
 
@@ -66,90 +511,634 @@ namespace micromatch::core
 
             // Submit order to book
             auto &book = it->second;
-            auto trades = book->add_order(order);
+            if (event_ns_ != 0)
+            {
+                book->set_clock(event_ns_);
+            }
+            trade_buffer_.clear();
+            book->add_order(order, trade_buffer_);
 
             // Notify order accepted
             if (order_callback_)
             {
-                order_callback_(order, true);
+                order_callback_(order, true);
+            }
+
+            publish_trades();
+        }
+
+        // Process cancel order
+        void process_cancel_order(uint64_t symbol_id, uint64_t order_id)
+        {
+            auto it = order_books_.find(symbol_id);
+            if (it == order_books_.end())
+            {
+                return;
+            }
+
+            auto &book = it->second;
+            if (book->cancel_order(order_id))
+            {
+                stats_.cancelled_orders.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        // Process mass cancel
+        void process_mass_cancel(uint64_t symbol_id, uint64_t client_id, std::optional<Side> side)
+        {
+            size_t cancelled = 0;
+            if (symbol_id == ALL_SYMBOLS)
+            {
+                for (auto &[id, book] : order_books_)
+                {
+                    cancelled += book->mass_cancel(client_id, side);
+                }
+            }
+            else if (auto it = order_books_.find(symbol_id); it != order_books_.end())
+            {
+                cancelled = it->second->mass_cancel(client_id, side);
+            }
+            stats_.cancelled_orders.fetch_add(cancelled, std::memory_order_relaxed);
+        }
+
+        // Process end-of-session purge of `symbol_id` (ALL_SYMBOLS = every book)
+        void process_purge_day(uint64_t symbol_id)
+        {
+            if (symbol_id == ALL_SYMBOLS)
+            {
+                for (auto &[id, book] : order_books_)
+                {
+                    book->purge_day_orders();
+                }
+            }
+            else if (auto it = order_books_.find(symbol_id); it != order_books_.end())
+            {
+                it->second->purge_day_orders();
+            }
+        }
+
+        // Process modify order
+        void process_modify_order(uint64_t symbol_id, uint64_t order_id,
+                                  int64_t new_price, uint32_t new_quantity)
+        {
+            auto it = order_books_.find(symbol_id);
+            if (it == order_books_.end())
+            {
+                return;
+            }
+
+            auto &book = it->second;
+            if (event_ns_ != 0)
+            {
+                book->set_clock(event_ns_);
+            }
+            trade_buffer_.clear();
+            const ModifyPath path = book->modify_order(order_id, new_price, new_quantity, trade_buffer_);
+            if (path == ModifyPath::NOT_FOUND || path == ModifyPath::REJECTED)
+            {
+                return;
+            }
+
+            stats_.modified_orders.fetch_add(1, std::memory_order_relaxed);
+            if (path == ModifyPath::IN_PLACE)
+            {
+                stats_.modified_in_place.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // A reprice that crosses the spread trades like a new order
+            publish_trades();
+        }
+
+        // Count and report the fills in trade_buffer_
+        void publish_trades()
+        {
+            for (const auto &trade : trade_buffer_)
+            {
+                stats_.total_trades.fetch_add(1, std::memory_order_relaxed);
+                stats_.total_volume.fetch_add(trade.quantity, std::memory_order_relaxed);
+
+                if (trade_callback_)
+                {
+                    trade_callback_(trade);
+                }
+            }
+        }
+
+        static uint64_t request_symbol(const OrderRequest &request)
+        {
+            return (request.type == OrderRequest::NEW_ORDER) ? request.order.symbol_id
+                                                             : request.symbol_id;
+        }
+
+        // Apply the interval's requests and uncross every book they touched.
+        // Requests are applied grouped by symbol, so each book is worked on
+        // in one pass; the sort is stable per symbol because the arrival
+        // index is part of the key, which keeps time priority intact.
+        void clear_batch()
+        {
+            batch_order_.clear();
+            for (size_t i = 0; i < batch_.size(); ++i)
+            {
+                const uint64_t symbol_id = request_symbol(batch_[i]);
+                if (symbol_id != ALL_SYMBOLS)
+                {
+                    batch_order_.emplace_back(symbol_id, static_cast<uint32_t>(i));
+                    continue;
+                }
+                // Apply an every-book request within each book's group so it
+                // keeps its place relative to that book's other requests
+                for (const auto &[id, book] : order_books_)
+                {
+                    batch_order_.emplace_back(id, static_cast<uint32_t>(i));
+                }
+            }
+            for (const uint64_t symbol_id : held_stops_)
+            {
+                batch_order_.emplace_back(symbol_id, NO_REQUEST);
+            }
+            held_stops_.clear();
+            std::sort(batch_order_.begin(), batch_order_.end());
+            if (journal_ && !batch_order_.empty())
+            {
+                event_ns_ = now_ns();
+                journal(JournalEntry::BATCH_CLEAR, event_ns_);
+            }
+
+            for (size_t i = 0; i < batch_order_.size();)
+            {
+                const uint64_t symbol_id = batch_order_[i].first;
+                for (; i < batch_order_.size() && batch_order_[i].first == symbol_id; ++i)
+                {
+                    if (batch_order_[i].second == NO_REQUEST)
+                    {
+                        continue;
+                    }
+                    const OrderRequest &request = batch_[batch_order_[i].second];
+                    if (request.type == OrderRequest::MASS_CANCEL && request.symbol_id == ALL_SYMBOLS)
+                    {
+                        process_mass_cancel(symbol_id, request.client_id, request.side);
+                    }
+                    else if (request.type == OrderRequest::PURGE_DAY)
+                    {
+                        process_purge_day(symbol_id);
+                    }
+                    else
+                    {
+                        process_order_request(request);
+                    }
+                }
+
+                auto it = order_books_.find(symbol_id);
+                if (it == order_books_.end())
+                {
+                    continue;
+                }
+                if (event_ns_ != 0)
+                {
+                    it->second->set_clock(event_ns_);
+                }
+                trade_buffer_.clear();
+                if (it->second->uncross(trade_buffer_, 0, true).held_stops > 0)
+                {
+                    held_stops_.push_back(symbol_id);
+                }
+                publish_trades();
+            }
+            batch_.clear();
+        }
+
+        // Expire due GTD orders on every book if the sweep interval has
+        // passed. Runs on the worker between requests, never inside one.
+        void run_expiry(std::chrono::steady_clock::time_point now)
+        {
+            if (now < next_expiry_)
+            {
+                return;
+            }
+            next_expiry_ = now + EXPIRY_INTERVAL;
+
+            const auto sweep_ns = static_cast<uint64_t>(now.time_since_epoch().count());
+            if (expire_all(sweep_ns) > 0 && journal_)
+            {
+                journal(JournalEntry::EXPIRE, sweep_ns);
+            }
+        }
+
+        // Expire due GTD orders on every book as of sweep_ns
+        size_t expire_all(uint64_t sweep_ns)
+        {
+            size_t expired = 0;
+            for (auto &[symbol_id, book] : order_books_)
+            {
+                expired += book->expire_orders(sweep_ns);
+            }
+            stats_.expired_orders.fetch_add(expired, std::memory_order_relaxed);
+            return expired;
+        }
+
+        // Counts from replaying one book, added to the engine stats at the end
+        struct ReplayTally
+        {
+            uint64_t orders{0};
+            uint64_t trades{0};
+            uint64_t volume{0};
+            uint64_t cancelled{0};
+            uint64_t modified{0};
+            uint64_t modified_in_place{0};
+            uint64_t expired{0};
+        };
+
+        // Apply one journaled request to its book, as the worker did
+        static void replay_request(IOrderBook &book, const JournalRecord &record,
+                                   std::vector<Trade> &trades, ReplayTally &tally)
+        {
+            trades.clear();
+            switch (record.entry)
+            {
+            case JournalEntry::NEW_ORDER:
+                ++tally.orders;
+                book.add_order(record.order, trades);
+                break;
+            case JournalEntry::CANCEL_ORDER:
+                tally.cancelled += book.cancel_order(record.order_id) ? 1 : 0;
+                break;
+            case JournalEntry::MODIFY_ORDER:
+            {
+                const ModifyPath path = book.modify_order(record.order_id, record.new_price,
+                                                          record.new_quantity, trades);
+                if (path != ModifyPath::NOT_FOUND && path != ModifyPath::REJECTED)
+                {
+                    ++tally.modified;
+                    tally.modified_in_place += (path == ModifyPath::IN_PLACE) ? 1 : 0;
+                }
+                break;
+            }
+            case JournalEntry::MASS_CANCEL:
+                tally.cancelled += book.mass_cancel(
+                    record.client_id, record.has_side ? std::optional<Side>(record.side) : std::nullopt);
+                break;
+            case JournalEntry::PURGE_DAY:
+                book.purge_day_orders();
+                break;
+            default:
+                break;
+            }
+            for (const auto &trade : trades)
+            {
+                ++tally.trades;
+                tally.volume += trade.quantity;
+            }
+        }
+
+        // Replay the records of one book (its own requests plus every
+        // engine-wide event) in journal order
+        void replay_book(IOrderBook &book, const JournalReader &reader,
+                         const std::vector<uint32_t> &records, ReplayTally &tally) const
+        {
+            std::vector<Trade> trades;
+            trades.reserve(TRADE_BUFFER_RESERVE);
+            std::vector<JournalRecord> pending; // Batch mode: requests awaiting the next clear
+            bool held_stops = false;            // Batch mode: the last clear triggered stops
+
+            for (const uint32_t index : records)
+            {
+                const JournalRecord record = reader[index];
+                switch (record.entry)
+                {
+                case JournalEntry::EXPIRE:
+                    tally.expired += book.expire_orders(record.timestamp_ns);
+                    break;
+
+                case JournalEntry::BATCH_CLEAR:
+                    if (pending.empty() && !held_stops)
+                    {
+                        break; // Book not touched this interval
+                    }
+                    book.set_clock(record.timestamp_ns);
+                    for (const auto &request : pending)
+                    {
+                        replay_request(book, request, trades, tally);
+                    }
+                    trades.clear();
+                    held_stops = book.uncross(trades, 0, true).held_stops > 0;
+                    for (const auto &trade : trades)
+                    {
+                        ++tally.trades;
+                        tally.volume += trade.quantity;
+                    }
+                    pending.clear();
+                    break;
+
+                default:
+                    if (config_.mode == MatchingMode::BATCH_AUCTION)
+                    {
+                        pending.push_back(record);
+                    }
+                    else
+                    {
+                        book.set_clock(record.timestamp_ns);
+                        replay_request(book, record, trades, tally);
+                    }
+                    break;
+                }
+            }
+        }
+
+        // Replay in journal order through the worker's own paths, so the
+        // callbacks see exactly what they saw live
+        void replay_in_order(const JournalReader &reader, uint64_t after_sequence)
+        {
+            for (size_t i = 0; i < reader.size(); ++i)
+            {
+                const JournalRecord record = reader[i];
+                if (record.sequence <= after_sequence)
+                {
+                    continue;
+                }
+                event_ns_ = record.timestamp_ns;
+                switch (record.entry)
+                {
+                case JournalEntry::EXPIRE:
+                    expire_all(record.timestamp_ns);
+                    break;
+                case JournalEntry::BATCH_CLEAR:
+                    clear_batch();
+                    break;
+                default:
+                    if (config_.mode == MatchingMode::BATCH_AUCTION)
+                    {
+                        batch_.push_back(journaled_request(record));
+                    }
+                    else
+                    {
+                        process_order_request(journaled_request(record));
+                    }
+                    break;
+                }
+            }
+            batch_.clear();
+        }
+
+        // Replay each book on its own, in parallel. One pass over the
+        // journal lists every book's records; engine-wide events go to
+        // every book's list.
+        void replay_by_book(const JournalReader &reader, uint64_t after_sequence, size_t threads)
+        {
+            std::vector<IOrderBook *> books;
+            std::unordered_map<uint64_t, size_t> book_index;
+            for (auto &[symbol_id, book] : order_books_)
+            {
+                book_index.emplace(symbol_id, books.size());
+                books.push_back(book.get());
+            }
+
+            std::vector<std::vector<uint32_t>> records(books.size());
+            uint64_t rejected = 0;
+            for (size_t i = 0; i < reader.size(); ++i)
+            {
+                const JournalRecord record = reader[i];
+                if (record.sequence <= after_sequence)
+                {
+                    continue;
+                }
+                const bool every_book = record.entry == JournalEntry::EXPIRE ||
+                                        record.entry == JournalEntry::BATCH_CLEAR ||
+                                        record.entry == JournalEntry::PURGE_DAY ||
+                                        (record.entry == JournalEntry::MASS_CANCEL &&
+                                         record.symbol_id == ALL_SYMBOLS);
+                if (every_book)
+                {
+                    for (auto &list : records)
+                    {
+                        list.push_back(static_cast<uint32_t>(i));
+                    }
+                }
+                else if (auto it = book_index.find(record.symbol_id); it != book_index.end())
+                {
+                    records[it->second].push_back(static_cast<uint32_t>(i));
+                }
+                else if (record.entry == JournalEntry::NEW_ORDER)
+                {
+                    ++rejected; // Symbol not registered
+                }
+            }
+
+            std::vector<ReplayTally> tallies(books.size());
+            std::atomic<size_t> next_book{0};
+            auto replay_books = [&]
+            {
+                for (size_t i = next_book++; i < books.size(); i = next_book++)
+                {
+                    replay_book(*books[i], reader, records[i], tallies[i]);
+                }
+            };
+            const size_t workers = std::min(books.size(),
+                                            threads ? threads : std::max(1u, std::thread::hardware_concurrency()));
+            std::vector<std::thread> pool;
+            for (size_t t = 1; t < workers; ++t)
+            {
+                pool.emplace_back(replay_books);
+            }
+            replay_books();
+            for (auto &thread : pool)
+            {
+                thread.join();
+            }
+
+            ReplayTally total;
+            for (const auto &tally : tallies)
+            {
+                total.orders += tally.orders;
+                total.trades += tally.trades;
+                total.volume += tally.volume;
+                total.cancelled += tally.cancelled;
+                total.modified += tally.modified;
+                total.modified_in_place += tally.modified_in_place;
+                total.expired += tally.expired;
+            }
+            stats_.total_orders.fetch_add(total.orders + rejected, std::memory_order_relaxed);
+            stats_.rejected_orders.fetch_add(rejected, std::memory_order_relaxed);
+            stats_.total_trades.fetch_add(total.trades, std::memory_order_relaxed);
+            stats_.total_volume.fetch_add(total.volume, std::memory_order_relaxed);
+            stats_.cancelled_orders.fetch_add(total.cancelled, std::memory_order_relaxed);
+            stats_.modified_orders.fetch_add(total.modified, std::memory_order_relaxed);
+            stats_.modified_in_place.fetch_add(total.modified_in_place, std::memory_order_relaxed);
+            stats_.expired_orders.fetch_add(total.expired, std::memory_order_relaxed);
+        }
+
+        // Return every book to reading the steady clock
+        void unpin_clocks()
+        {
+            event_ns_ = 0;
+            for (auto &[symbol_id, book] : order_books_)
+            {
+                book->set_clock(0);
+            }
+        }
+
+        // The calling thread's ingress ring, claimed on its first submit
+        IngressRing &producer_ring()
+        {
+            thread_local ProducerSlots slots;
+            return slots.ring(engine_id_, ingress_);
+        }
+
+        // Queue a request on the calling thread's ring, waiting while it is full
+        void push_request(OrderRequest &&request)
+        {
+            IngressRing &ring = producer_ring();
+            while (!ring.try_push(std::move(request)))
+            {
+                idle_.notify();
+                std::this_thread::yield();
             }
+            idle_.notify();
+        }
 
-            // Process generated trades
-            for (const auto &trade : trades)
+        // Apply fn to up to `limit` queued requests, visiting the rings
+        // round-robin and taking at most INGRESS_BURST from each in turn.
+        // Each burst is applied where it lies in the ring and released
+        // with one store. Stops early once a whole round finds every ring
+        // empty.
+        template <typename Fn>
+        size_t drain_ingress(size_t limit, Fn &&fn)
+        {
+            const size_t producers = ingress_->count();
+            size_t drained = 0;
+            size_t empty_rings = 0;
+            while (drained < limit && empty_rings < producers)
             {
-                stats_.total_trades.fetch_add(1, std::memory_order_relaxed);
-                stats_.total_volume.fetch_add(trade.quantity, std::memory_order_relaxed);
+                IngressRegistry::Slot &slot = ingress_->slot(ingress_cursor_);
+                ingress_cursor_ = (ingress_cursor_ + 1 == producers) ? 0 : ingress_cursor_ + 1;
 
-                if (trade_callback_)
+                // A retired ring gets no more requests: once it is found
+                // empty it can go to the next thread
+                const uint8_t state = slot.state.load(std::memory_order_acquire);
+                size_t taken = 0;
+                if (state != IngressRegistry::FREE)
                 {
-                    trade_callback_(trade);
+                    taken = slot.ring->consume(fn, std::min(INGRESS_BURST, limit - drained));
+                    if (taken == 0 && state == IngressRegistry::RETIRED)
+                    {
+                        slot.state.store(IngressRegistry::FREE, std::memory_order_release);
+                    }
                 }
+                drained += taken;
+                empty_rings = (taken == 0) ? empty_rings + 1 : 0;
             }
+            return drained;
         }
 
-        // Process cancel order
-        void process_cancel_order(uint64_t symbol_id, uint64_t order_id)
+        bool ingress_empty() const
         {
-            auto it = order_books_.find(symbol_id);
-            if (it == order_books_.end())
-            {
-                return;
-            }
-
-            auto &book = it->second;
-            if (book->cancel_order(order_id))
+            const size_t producers = ingress_->count();
+            for (size_t i = 0; i < producers; ++i)
             {
-                stats_.cancelled_orders.fetch_add(1, std::memory_order_relaxed);
+                if (!ingress_->slot(i).ring->empty())
+                {
+                    return false;
+                }
             }
+            return true;
         }
 
-        // Process modify order
-        void process_modify_order(uint64_t symbol_id, uint64_t order_id,
-                                  int64_t new_price, uint32_t new_quantity)
+        // Worker thread function for batch auction mode
+        void batch_worker_loop()
         {
-            auto it = order_books_.find(symbol_id);
-            if (it == order_books_.end())
+            auto collect = [this](const OrderRequest &request)
             {
-                return;
-            }
+                journal(request);
+                batch_.push_back(request);
+            };
 
-            auto &book = it->second;
-            auto modified = book->modify_order(order_id, new_price, new_quantity);
-            if (modified.has_value())
+            auto next_clear = std::chrono::steady_clock::now() + config_.batch_interval;
+            while (running_.load(std::memory_order_acquire))
             {
-                stats_.modified_orders.fetch_add(1, std::memory_order_relaxed);
+                const size_t drained = drain_ingress(BATCH_CLOCK_CHECK, collect);
+                if (drained > 0)
+                {
+                    idle_.reset();
+                }
+
+                const auto now = std::chrono::steady_clock::now();
+                run_expiry(now);
+                if (now >= next_clear)
+                {
+                    clear_batch();
+                    next_clear = now + config_.batch_interval;
+                }
+                else if (drained == 0)
+                {
+                    if (journal_)
+                    {
+                        journal_->drain_backlog();
+                    }
+                    idle_.idle([this]
+                               { return !ingress_empty(); },
+                               std::min<std::chrono::nanoseconds>(next_clear - now, EXPIRY_INTERVAL));
+                }
+            }
 
-                // Modification may generate trades (since it's cancel + new order)
-                // Those are already handled by the order book
+            // Clear whatever was collected before shutdown
+            while (drain_ingress(SIZE_MAX, collect) > 0)
+            {
             }
+            clear_batch();
         }
 
         // Worker thread function
         void worker_loop()
         {
+            auto apply = [this](const OrderRequest &request)
+            {
+                journal(request);
+                process_order_request(request);
+            };
+
+            size_t since_clock = 0;
             while (running_.load(std::memory_order_acquire))
             {
-                auto request = order_queue_.dequeue();
-                if (request.has_value())
+                const size_t drained = drain_ingress(EXPIRY_CLOCK_CHECK, apply);
+                if (drained > 0)
                 {
-                    process_order_request(*request);
+                    idle_.reset();
+                    since_clock += drained;
+                    if (since_clock >= EXPIRY_CLOCK_CHECK)
+                    {
+                        since_clock = 0;
+                        run_expiry(std::chrono::steady_clock::now());
+                    }
                 }
                 else
                 {
-                    // No orders, sleep briefly
-                    std::this_thread::sleep_for(std::chrono::microseconds(10));
+                    run_expiry(std::chrono::steady_clock::now());
+                    if (journal_)
+                    {
+                        journal_->drain_backlog();
+                    }
+
+                    // No orders: wait per the configured strategy, waking
+                    // at least once per expiry interval
+                    idle_.idle([this]
+                               { return !ingress_empty(); },
+                               EXPIRY_INTERVAL);
                 }
             }
 
             // Process remaining orders before shutdown
-            while (auto request = order_queue_.dequeue())
+            while (drain_ingress(SIZE_MAX, apply) > 0)
             {
-                process_order_request(*request);
             }
         }
 
     public:
-        MatchingEngineImpl() = default;
+        explicit MatchingEngineImpl(const MatchingEngineConfig &config = MatchingEngineConfig{})
+            : config_(config),
+              ingress_(std::make_shared<IngressRegistry>(config.ingress_capacity)),
+              idle_(config.wait_strategy)
+        {
+            trade_buffer_.reserve(TRADE_BUFFER_RESERVE);
+        }
 
         ~MatchingEngineImpl()
         {
@@ -166,12 +1155,7 @@ namespace micromatch::core
                 throw std::runtime_error("Matching engine is not running");
             }
 
-            auto request = OrderRequest::new_order(std::move(order));
-            while (!order_queue_.enqueue(std::move(request)))
-            {
-                // Queue full, wait briefly
-                std::this_thread::yield();
-            }
+            push_request(OrderRequest::new_order(std::move(order)));
         }
 
         void cancel_order(uint64_t symbol_id, uint64_t order_id) override
@@ -181,11 +1165,7 @@ namespace micromatch::core
                 throw std::runtime_error("Matching engine is not running");
             }
 
-            auto request = OrderRequest::cancel_order(symbol_id, order_id);
-            while (!order_queue_.enqueue(std::move(request)))
-            {
-                std::this_thread::yield();
-            }
+            push_request(OrderRequest::cancel_order(symbol_id, order_id));
         }
 
         void modify_order(uint64_t symbol_id, uint64_t order_id,
@@ -196,11 +1176,17 @@ namespace micromatch::core
                 throw std::runtime_error("Matching engine is not running");
             }
 
-            auto request = OrderRequest::modify_order(symbol_id, order_id, new_price, new_quantity);
-            while (!order_queue_.enqueue(std::move(request)))
+            push_request(OrderRequest::modify_order(symbol_id, order_id, new_price, new_quantity));
+        }
+
+        void mass_cancel(uint64_t symbol_id, uint64_t client_id, std::optional<Side> side) override
+        {
+            if (!running_)
             {
-                std::this_thread::yield();
+                throw std::runtime_error("Matching engine is not running");
             }
+
+            push_request(OrderRequest::mass_cancel(symbol_id, client_id, side));
         }
 
         bool register_symbol(uint64_t symbol_id) override
@@ -210,7 +1196,12 @@ namespace micromatch::core
                 return false; // Already registered
             }
 
-            order_books_[symbol_id] = create_order_book(symbol_id);
+            auto book = create_order_book(symbol_id, config_.book_config);
+            if (config_.mode == MatchingMode::BATCH_AUCTION)
+            {
+                book->begin_auction();
+            }
+            order_books_[symbol_id] = std::move(book);
             return true;
         }
 
@@ -253,6 +1244,8 @@ namespace micromatch::core
             snapshot.cancelled_orders = stats_.cancelled_orders.load(std::memory_order_relaxed);
             snapshot.rejected_orders = stats_.rejected_orders.load(std::memory_order_relaxed);
             snapshot.modified_orders = stats_.modified_orders.load(std::memory_order_relaxed);
+            snapshot.modified_in_place = stats_.modified_in_place.load(std::memory_order_relaxed);
+            snapshot.expired_orders = stats_.expired_orders.load(std::memory_order_relaxed);
             return snapshot;
         }
 
@@ -261,7 +1254,98 @@ namespace micromatch::core
             for (auto &[symbol_id, book] : order_books_)
             {
                 book->clear();
+                if (config_.mode == MatchingMode::BATCH_AUCTION)
+                {
+                    book->begin_auction();
+                }
+            }
+        }
+
+        void purge_day_orders() override
+        {
+            // The books belong to the worker while it runs
+            if (running_)
+            {
+                push_request(OrderRequest::purge_day_orders());
+                return;
+            }
+            process_purge_day(ALL_SYMBOLS);
+        }
+
+        bool save_checkpoint(const std::string &path) const override
+        {
+            if (running_)
+            {
+                return false;
+            }
+            std::vector<const IOrderBook *> books;
+            collect_books(books);
+            return write_engine_checkpoint(path, books);
+        }
+
+        bool restore_checkpoint(const std::string &path) override
+        {
+            if (running_)
+            {
+                return false;
+            }
+            std::vector<std::unique_ptr<IOrderBook>> books;
+            if (!read_engine_checkpoint(path, config_.book_config, books) || has_duplicate_symbols(books))
+            {
+                return false;
+            }
+            adopt_books(std::move(books));
+            return true;
+        }
+
+        // Append every book to `books`
+        void collect_books(std::vector<const IOrderBook *> &books) const
+        {
+            for (const auto &[symbol_id, book] : order_books_)
+            {
+                books.push_back(book.get());
+            }
+        }
+
+        // Replace every book with `books`, whose symbols are distinct
+        void adopt_books(std::vector<std::unique_ptr<IOrderBook>> books)
+        {
+            std::unordered_map<uint64_t, std::unique_ptr<IOrderBook>> adopted;
+            for (auto &book : books)
+            {
+                if (config_.mode == MatchingMode::BATCH_AUCTION && !book->in_auction())
+                {
+                    book->begin_auction();
+                }
+                const uint64_t symbol_id = book->symbol_id();
+                adopted.emplace(symbol_id, std::move(book));
+            }
+            order_books_ = std::move(adopted);
+        }
+
+        bool replay_journal(const std::string &path, const ReplayOptions &options) override
+        {
+            if (running_)
+            {
+                return false;
+            }
+
+            const JournalReader reader(path);
+            if (!reader.valid())
+            {
+                return false;
+            }
+
+            if (options.publish)
+            {
+                replay_in_order(reader, options.after_sequence);
+            }
+            else
+            {
+                replay_by_book(reader, options.after_sequence, options.threads);
             }
+            unpin_clocks();
+            return true;
         }
 
         void start() override
@@ -271,7 +1355,20 @@ namespace micromatch::core
                 throw std::runtime_error("Matching engine already running");
             }
 
-            worker_thread_ = std::thread(&MatchingEngineImpl::worker_loop, this);
+            if (config_.journal)
+            {
+                journal_ = open_journal(*config_.journal);
+                if (!journal_)
+                {
+                    running_ = false;
+                    throw std::runtime_error("Could not open journal " + config_.journal->path);
+                }
+                journal_sequence_ = journal_->last_sequence();
+            }
+
+            worker_thread_ = (config_.mode == MatchingMode::BATCH_AUCTION)
+                                 ? std::thread(&MatchingEngineImpl::batch_worker_loop, this)
+                                 : std::thread(&MatchingEngineImpl::worker_loop, this);
         }
 
         void stop() override
@@ -281,10 +1378,18 @@ namespace micromatch::core
                 return; // Already stopped
             }
 
+            idle_.wake();
             if (worker_thread_.joinable())
             {
                 worker_thread_.join();
             }
+
+            // Closing the journal writes and syncs everything the worker applied
+            if (journal_)
+            {
+                journal_.reset();
+                unpin_clocks();
+            }
         }
 
         bool is_running() const override
@@ -293,10 +1398,238 @@ namespace micromatch::core
         }
     };
 
+    // Symbols partitioned across independent engines, each with its own
+    // queue, worker thread and books. Per-symbol requests go to the shard
+    // that owns the symbol; engine-wide ones go to every shard.
+    class ShardedMatchingEngine : public IMatchingEngine
+    {
+    private:
+        std::vector<std::unique_ptr<MatchingEngineImpl>> shards_;
+        OrderBookConfig book_config_;
+
+        size_t shard_index(uint64_t symbol_id) const
+        {
+            return symbol_id % shards_.size();
+        }
+
+        MatchingEngineImpl &shard(uint64_t symbol_id)
+        {
+            return *shards_[shard_index(symbol_id)];
+        }
+
+        static std::string shard_path(const std::string &path, size_t index)
+        {
+            return path + "." + std::to_string(index);
+        }
+
+    public:
+        explicit ShardedMatchingEngine(const MatchingEngineConfig &config)
+            : book_config_(config.book_config)
+        {
+            for (size_t i = 0; i < config.shards; ++i)
+            {
+                MatchingEngineConfig shard_config = config;
+                shard_config.shards = 1;
+                if (shard_config.journal)
+                {
+                    shard_config.journal->path = shard_path(config.journal->path, i);
+                }
+                shards_.push_back(std::make_unique<MatchingEngineImpl>(shard_config));
+            }
+        }
+
+        void submit_order(Order order) override
+        {
+            shard(order.symbol_id).submit_order(std::move(order));
+        }
+
+        void cancel_order(uint64_t symbol_id, uint64_t order_id) override
+        {
+            shard(symbol_id).cancel_order(symbol_id, order_id);
+        }
+
+        void modify_order(uint64_t symbol_id, uint64_t order_id,
+                          int64_t new_price, uint32_t new_quantity) override
+        {
+            shard(symbol_id).modify_order(symbol_id, order_id, new_price, new_quantity);
+        }
+
+        void mass_cancel(uint64_t symbol_id, uint64_t client_id, std::optional<Side> side) override
+        {
+            if (symbol_id != ALL_SYMBOLS)
+            {
+                shard(symbol_id).mass_cancel(symbol_id, client_id, side);
+                return;
+            }
+            for (auto &engine : shards_)
+            {
+                engine->mass_cancel(symbol_id, client_id, side);
+            }
+        }
+
+        bool register_symbol(uint64_t symbol_id) override
+        {
+            return shard(symbol_id).register_symbol(symbol_id);
+        }
+
+        bool unregister_symbol(uint64_t symbol_id) override
+        {
+            return shard(symbol_id).unregister_symbol(symbol_id);
+        }
+
+        IOrderBook *get_order_book(uint64_t symbol_id) override
+        {
+            return shard(symbol_id).get_order_book(symbol_id);
+        }
+
+        void set_trade_callback(TradeCallback callback) override
+        {
+            for (auto &engine : shards_)
+            {
+                engine->set_trade_callback(callback);
+            }
+        }
+
+        void set_order_callback(OrderCallback callback) override
+        {
+            for (auto &engine : shards_)
+            {
+                engine->set_order_callback(callback);
+            }
+        }
+
+        MatchingEngineStatsSnapshot get_stats() const override
+        {
+            MatchingEngineStatsSnapshot total{};
+            for (const auto &engine : shards_)
+            {
+                const auto stats = engine->get_stats();
+                total.total_orders += stats.total_orders;
+                total.total_trades += stats.total_trades;
+                total.total_volume += stats.total_volume;
+                total.rejected_orders += stats.rejected_orders;
+                total.cancelled_orders += stats.cancelled_orders;
+                total.modified_orders += stats.modified_orders;
+                total.modified_in_place += stats.modified_in_place;
+                total.expired_orders += stats.expired_orders;
+            }
+            return total;
+        }
+
+        void clear_all_books() override
+        {
+            for (auto &engine : shards_)
+            {
+                engine->clear_all_books();
+            }
+        }
+
+        void purge_day_orders() override
+        {
+            for (auto &engine : shards_)
+            {
+                engine->purge_day_orders();
+            }
+        }
+
+        bool save_checkpoint(const std::string &path) const override
+        {
+            if (is_running())
+            {
+                return false;
+            }
+            std::vector<const IOrderBook *> books;
+            for (const auto &engine : shards_)
+            {
+                engine->collect_books(books);
+            }
+            return write_engine_checkpoint(path, books);
+        }
+
+        // Any checkpoint restores, whatever shard count wrote it: books are
+        // handed to whichever shard owns their symbol now
+        bool restore_checkpoint(const std::string &path) override
+        {
+            if (is_running())
+            {
+                return false;
+            }
+            std::vector<std::unique_ptr<IOrderBook>> books;
+            if (!read_engine_checkpoint(path, book_config_, books) || has_duplicate_symbols(books))
+            {
+                return false;
+            }
+
+            std::vector<std::vector<std::unique_ptr<IOrderBook>>> by_shard(shards_.size());
+            for (auto &book : books)
+            {
+                by_shard[shard_index(book->symbol_id())].push_back(std::move(book));
+            }
+            for (size_t i = 0; i < shards_.size(); ++i)
+            {
+                shards_[i]->adopt_books(std::move(by_shard[i]));
+            }
+            return true;
+        }
+
+        bool replay_journal(const std::string &path, const ReplayOptions &options) override
+        {
+            for (size_t i = 0; i < shards_.size(); ++i)
+            {
+                if (!shards_[i]->replay_journal(shard_path(path, i), options))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void start() override
+        {
+            for (size_t i = 0; i < shards_.size(); ++i)
+            {
+                try
+                {
+                    shards_[i]->start();
+                }
+                catch (...)
+                {
+                    for (size_t j = 0; j < i; ++j)
+                    {
+                        shards_[j]->stop();
+                    }
+                    throw;
+                }
+            }
+        }
+
+        void stop() override
+        {
+            for (auto &engine : shards_)
+            {
+                engine->stop();
+            }
+        }
+
+        bool is_running() const override
+        {
+            return shards_.front()->is_running();
+        }
+    };
+
     // Factory function implementation
     std::unique_ptr<IMatchingEngine> create_matching_engine()
     {
         return std::make_unique<MatchingEngineImpl>();
     }
 
+    std::unique_ptr<IMatchingEngine> create_matching_engine(const MatchingEngineConfig &config)
+    {
+        if (config.shards > 1)
+        {
+            return std::make_unique<ShardedMatchingEngine>(config);
+        }
+        return std::make_unique<MatchingEngineImpl>(config);
+    }
+
 } // namespace micromatch::core
\ No newline at end of file
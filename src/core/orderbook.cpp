@@ -1,413 +1,2158 @@
 #include "core/orderbook.hpp"
+#include "utils/slab_pool.hpp"
+#include "utils/occupancy_bitmap.hpp"
+#include "utils/flat_id_map.hpp"
+#include "utils/timer_wheel.hpp"
 #include <map>
-#include <unordered_map>
-#include <queue>
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <type_traits>
 #include <iostream>
 
 namespace micromatch::core
 {
 
+    // Hot half of a resting order: just what the matcher touches while
+    // walking a level, packed so two nodes share a cache line. The full
+    // order record (price, side, client, timestamps, ...) lives in a
+    // parallel column indexed by the same pool handle; the remaining
+    // quantity here is authoritative over the copy in that record.
+    struct alignas(32) OrderNode
+    {
+        uint64_t order_id;
+        OrderNode *prev{nullptr};
+        OrderNode *next{nullptr};
+        uint32_t quantity; // Remaining quantity
+        uint32_t handle{0}; // Slot in the owning book's pool and order column
+
+        OrderNode(uint64_t id, uint32_t qty) noexcept : order_id(id), quantity(qty) {}
+    };
+
+    static_assert(sizeof(OrderNode) == 32, "OrderNode must stay half a cache line");
+
+    using OrderPool = utils::SlabPool<OrderNode>;
+    using OrderColumn = utils::SlabColumn<Order>;
+
     // Price level containing orders at a specific price
+    // Orders form an intrusive doubly-linked FIFO so any order can be
+    // unlinked in O(1) given its node
     class PriceLevelImpl
     {
     private:
         int64_t price_;
-        std::queue<std::shared_ptr<Order>> orders_;
+        OrderNode *head_{nullptr};
+        OrderNode *tail_{nullptr};
+        size_t order_count_{0};
         uint32_t total_volume_{0};
 
     public:
+        PriceLevelImpl() : price_(0) {}
         explicit PriceLevelImpl(int64_t price) : price_(price) {}
 
-        void add_order(std::shared_ptr<Order> order)
+        // Re-target an empty level at a new price (dense ladder slots are reused)
+        void reset(int64_t price)
         {
-            assert(order->price == price_);
-            orders_.push(order);
-            total_volume_ += order->quantity;
+            assert(empty());
+            price_ = price;
+            total_volume_ = 0;
         }
 
-        std::shared_ptr<Order> peek_front() const
+        // Move every order of `other` (same price) into this empty level
+        void take_orders_from(PriceLevelImpl &other)
         {
-            return orders_.empty() ? nullptr : orders_.front();
+            assert(empty() && other.price_ == price_);
+            head_ = other.head_;
+            tail_ = other.tail_;
+            order_count_ = other.order_count_;
+            total_volume_ = other.total_volume_;
+            other.head_ = other.tail_ = nullptr;
+            other.order_count_ = 0;
+            other.total_volume_ = 0;
         }
 
-        void remove_front()
+        void add_order(OrderNode *node)
         {
-            if (!orders_.empty())
+            node->prev = tail_;
+            node->next = nullptr;
+            if (tail_)
+            {
+                tail_->next = node;
+            }
+            else
             {
-                total_volume_ -= orders_.front()->quantity;
-                orders_.pop();
+                head_ = node;
             }
+            tail_ = node;
+            ++order_count_;
+            total_volume_ += node->quantity;
+        }
+
+        OrderNode *peek_front() const
+        {
+            return head_;
         }
 
         void remove_front_after_fill(uint32_t filled_quantity)
         {
-            if (!orders_.empty())
+            if (head_)
+            {
+                // The order has already been filled, so we subtract the filled quantity
+                total_volume_ -= filled_quantity;
+                unlink(head_);
+            }
+        }
+
+        void remove_order(OrderNode *node)
+        {
+            total_volume_ -= node->quantity;
+            unlink(node);
+        }
+
+        // Change a resting order's quantity without touching its position
+        void update_quantity(OrderNode *node, uint32_t new_quantity)
+        {
+            total_volume_ = total_volume_ - node->quantity + new_quantity;
+            node->quantity = new_quantity;
+        }
+
+        void update_volume_after_partial_fill(uint32_t filled_quantity)
+        {
+            // Simply subtract the filled quantity from total volume
+            total_volume_ -= filled_quantity;
+        }
+
+        bool empty() const { return head_ == nullptr; }
+        size_t order_count() const { return order_count_; }
+        uint32_t volume() const { return total_volume_; }
+        int64_t price() const { return price_; }
+
+    private:
+        void unlink(OrderNode *node)
+        {
+            if (node->prev)
+            {
+                node->prev->next = node->next;
+            }
+            else
+            {
+                head_ = node->next;
+            }
+
+            if (node->next)
+            {
+                node->next->prev = node->prev;
+            }
+            else
+            {
+                tail_ = node->prev;
+            }
+
+            node->prev = nullptr;
+            node->next = nullptr;
+            --order_count_;
+        }
+    };
+
+    // Level currently holding each resting order, indexed by pool handle.
+    // Kept outside the hot node so cancels stay O(1) without widening it.
+    using LevelIndex = utils::SlabColumn<PriceLevelImpl *>;
+
+    // Links chaining each client's resting orders by pool handle
+    struct ClientLink
+    {
+        static constexpr uint32_t NONE = UINT32_MAX;
+        static constexpr uint32_t CANCELLED = UINT32_MAX - 1; // Mid mass cancel
+
+        uint32_t prev{NONE};
+        uint32_t next{NONE};
+        uint32_t client{NONE}; // Slot in the client table, NONE if untracked
+    };
+    using ClientColumn = utils::SlabColumn<ClientLink>;
+
+    // Links chaining the resting DAY orders by pool handle
+    struct DayLink
+    {
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        uint32_t prev{NONE};
+        uint32_t next{NONE};
+    };
+    using DayColumn = utils::SlabColumn<DayLink>;
+
+    // Level storage backed by a red-black tree, ordered best price first
+    template <typename Compare>
+    class MapLevels
+    {
+    private:
+        std::map<int64_t, std::unique_ptr<PriceLevelImpl>, Compare> levels_;
+
+    public:
+        // Tree levels never move, so the level index needs no upkeep here
+        MapLevels(const OrderBookConfig &, LevelIndex *) {}
+
+        PriceLevelImpl *best() const
+        {
+            return levels_.empty() ? nullptr : levels_.begin()->second.get();
+        }
+
+        PriceLevelImpl *find(int64_t price) const
+        {
+            auto it = levels_.find(price);
+            return (it != levels_.end()) ? it->second.get() : nullptr;
+        }
+
+        PriceLevelImpl *get_or_create(int64_t price)
+        {
+            auto &level = levels_[price];
+            if (!level)
+            {
+                level = std::make_unique<PriceLevelImpl>(price);
+            }
+            return level.get();
+        }
+
+        // Drop a level once its last order is gone
+        void erase(PriceLevelImpl *level)
+        {
+            levels_.erase(level->price());
+        }
+
+        // Visit levels best first until fn returns false
+        template <typename Fn>
+        void for_each_level(Fn &&fn) const
+        {
+            for (const auto &[price, level] : levels_)
+            {
+                if (!fn(*level))
+                {
+                    return;
+                }
+            }
+        }
+
+        bool empty() const { return levels_.empty(); }
+        void clear() { levels_.clear(); }
+    };
+
+    // Level storage backed by a contiguous array of levels indexed by
+    // (price - base) / tick_size. The window is re-centred on the next
+    // incoming price whenever it holds no live levels, and on a price that
+    // improves on its best level from outside it, so it follows the touch
+    // however the market drifts; other prices outside the window or off
+    // the tick grid fall back to an overflow tree. Live slots
+    // are tracked in an occupancy bitmap so the next best level after the
+    // touch empties is found with a few word scans however thin the book is.
+    template <typename Compare>
+    class LadderLevels
+    {
+    private:
+        static constexpr bool DESCENDING = std::is_same_v<Compare, std::greater<int64_t>>;
+        static constexpr size_t NO_LEVEL = utils::OccupancyBitmap::NPOS;
+
+        int64_t tick_size_;
+        int64_t base_price_{0}; // Price of slot 0
+        bool centred_{false};
+        size_t slot_count_;
+        std::unique_ptr<PriceLevelImpl[]> slots_;
+        utils::OccupancyBitmap live_;
+        size_t live_count_{0};
+        size_t best_index_{NO_LEVEL}; // Best live slot, NO_LEVEL if the window is empty
+
+        std::map<int64_t, std::unique_ptr<PriceLevelImpl>, Compare> overflow_;
+
+        // Re-pointed for orders whose level migrates into the window
+        LevelIndex *level_index_;
+
+        // Slot index for a price, NO_LEVEL if it is outside the window
+        size_t index_of(int64_t price) const
+        {
+            if (!centred_)
+            {
+                return NO_LEVEL;
+            }
+            const int64_t offset = price - base_price_;
+            if (offset < 0 || offset % tick_size_ != 0)
+            {
+                return NO_LEVEL;
+            }
+            const auto index = static_cast<size_t>(offset / tick_size_);
+            return (index < slot_count_) ? index : NO_LEVEL;
+        }
+
+        // True if slot a holds a better price than slot b
+        static bool better(size_t a, size_t b)
+        {
+            return DESCENDING ? a > b : a < b;
+        }
+
+        // First live slot at or beyond `from` in the direction of worse prices
+        size_t scan_from(size_t from) const
+        {
+            if (live_count_ == 0)
+            {
+                return NO_LEVEL;
+            }
+            return DESCENDING ? live_.find_prev(from) : live_.find_next(from);
+        }
+
+        // Re-point the orders of a level that has moved
+        void repoint(PriceLevelImpl &level)
+        {
+            for (OrderNode *node = level.peek_front(); node; node = node->next)
+            {
+                (*level_index_)[node->handle] = &level;
+            }
+        }
+
+        // Place `price` in the middle of the window. Live slots are parked
+        // in the overflow tree, then every overflow level that falls inside
+        // the new window is pulled into its slot, so levels still in range
+        // come straight back and the rest stay in the tree.
+        void recentre(int64_t price)
+        {
+            for (size_t i = live_.first(); live_count_ > 0 && i != NO_LEVEL; i = live_.find_next(i + 1))
+            {
+                auto level = std::make_unique<PriceLevelImpl>(slots_[i].price());
+                level->take_orders_from(slots_[i]);
+                repoint(*level);
+                overflow_.emplace(level->price(), std::move(level));
+            }
+            live_.reset();
+            live_count_ = 0;
+            best_index_ = NO_LEVEL;
+
+            base_price_ = price - static_cast<int64_t>(slot_count_ / 2) * tick_size_;
+            centred_ = true;
+
+            for (auto it = overflow_.begin(); it != overflow_.end();)
+            {
+                const size_t index = index_of(it->first);
+                if (index == NO_LEVEL)
+                {
+                    ++it;
+                    continue;
+                }
+                PriceLevelImpl &slot = slots_[index];
+                slot.reset(it->first);
+                slot.take_orders_from(*it->second);
+                repoint(slot);
+                mark_live(index);
+                it = overflow_.erase(it);
+            }
+        }
+
+        // Next live slot after `index` in the direction of worse prices
+        size_t next_after(size_t index) const
+        {
+            if (DESCENDING)
+            {
+                return (index == 0) ? NO_LEVEL : live_.find_prev(index - 1);
+            }
+            return live_.find_next(index + 1);
+        }
+
+        void mark_live(size_t index)
+        {
+            live_.set(index);
+            ++live_count_;
+            if (best_index_ == NO_LEVEL || better(index, best_index_))
+            {
+                best_index_ = index;
+            }
+        }
+
+    public:
+        LadderLevels(const OrderBookConfig &config, LevelIndex *level_index)
+            : tick_size_(config.tick_size > 0 ? config.tick_size : 1),
+              slot_count_(config.ladder_levels > 0 ? config.ladder_levels : 1),
+              slots_(std::make_unique<PriceLevelImpl[]>(slot_count_)),
+              live_(slot_count_),
+              level_index_(level_index)
+        {
+            if (config.reference_price > 0)
+            {
+                recentre(config.reference_price);
+            }
+        }
+
+        PriceLevelImpl *best() const
+        {
+            PriceLevelImpl *in_window = (best_index_ != NO_LEVEL) ? &slots_[best_index_] : nullptr;
+            if (overflow_.empty())
+            {
+                return in_window;
+            }
+            PriceLevelImpl *outside = overflow_.begin()->second.get();
+            if (!in_window || Compare{}(outside->price(), in_window->price()))
+            {
+                return outside;
+            }
+            return in_window;
+        }
+
+        PriceLevelImpl *find(int64_t price) const
+        {
+            const size_t index = index_of(price);
+            if (index != NO_LEVEL)
+            {
+                return live_.test(index) ? &slots_[index] : nullptr;
+            }
+            auto it = overflow_.find(price);
+            return (it != overflow_.end()) ? it->second.get() : nullptr;
+        }
+
+        // A price outside the window re-centres it if the window is empty,
+        // or if the price is on the tick grid and better than the window's
+        // best level: the touch has moved off the window, and it is the
+        // touch that belongs in the slots
+        PriceLevelImpl *get_or_create(int64_t price)
+        {
+            size_t index = index_of(price);
+            if (index == NO_LEVEL &&
+                (live_count_ == 0 || ((price - base_price_) % tick_size_ == 0 &&
+                                      Compare{}(price, slots_[best_index_].price()))))
+            {
+                recentre(price);
+                index = index_of(price);
+            }
+
+            if (index != NO_LEVEL)
+            {
+                PriceLevelImpl &slot = slots_[index];
+                if (!live_.test(index))
+                {
+                    slot.reset(price);
+                    mark_live(index);
+                }
+                return &slot;
+            }
+
+            auto &level = overflow_[price];
+            if (!level)
+            {
+                level = std::make_unique<PriceLevelImpl>(price);
+            }
+            return level.get();
+        }
+
+        // Drop a level once its last order is gone
+        void erase(PriceLevelImpl *level)
+        {
+            if (level < slots_.get() || level >= slots_.get() + slot_count_)
+            {
+                overflow_.erase(level->price());
+                return;
+            }
+
+            const auto index = static_cast<size_t>(level - slots_.get());
+            live_.clear(index);
+            --live_count_;
+            if (index == best_index_)
+            {
+                best_index_ = scan_from(index);
+            }
+        }
+
+        // Visit levels best first until fn returns false, merging the window
+        // with the overflow tree so off-window prices appear in order
+        template <typename Fn>
+        void for_each_level(Fn &&fn) const
+        {
+            size_t index = best_index_;
+            auto it = overflow_.begin();
+            while (index != NO_LEVEL || it != overflow_.end())
+            {
+                const PriceLevelImpl *level;
+                if (it == overflow_.end() ||
+                    (index != NO_LEVEL && !Compare{}(it->first, slots_[index].price())))
+                {
+                    level = &slots_[index];
+                    index = next_after(index);
+                }
+                else
+                {
+                    level = it->second.get();
+                    ++it;
+                }
+
+                if (!fn(*level))
+                {
+                    return;
+                }
+            }
+        }
+
+        bool empty() const { return live_count_ == 0 && overflow_.empty(); }
+
+        void clear()
+        {
+            for (size_t i = live_.first(); i != NO_LEVEL; i = live_.find_next(i + 1))
+            {
+                slots_[i] = PriceLevelImpl();
+            }
+            live_.reset();
+            live_count_ = 0;
+            best_index_ = NO_LEVEL;
+            overflow_.clear();
+        }
+    };
+
+    // Best MAX_DEPTH levels of one side, kept sorted best first and patched
+    // as individual levels change so a depth query is a straight copy.
+    // Removing a cached level from a full cache may expose a level that was
+    // never cached; the cache is then marked incomplete and refilled from
+    // the level store on the next query, so a burst of removals during a
+    // sweep costs one refill rather than one per level.
+    template <typename Compare>
+    class DepthCache
+    {
+    private:
+        static constexpr size_t CAPACITY = OrderBookDepth::MAX_DEPTH;
+
+        std::array<PriceLevel, CAPACITY> levels_;
+        size_t size_{0};
+        bool complete_{true}; // False if uncached levels may rank within the top CAPACITY
+
+    public:
+        // Record the current state of a level; an empty level is removed
+        void update(const PriceLevelImpl &level)
+        {
+            const int64_t price = level.price();
+            size_t i = 0;
+            while (i < size_ && Compare{}(levels_[i].price, price))
+            {
+                ++i;
+            }
+            const bool cached = i < size_ && levels_[i].price == price;
+
+            if (level.empty())
+            {
+                if (cached)
+                {
+                    std::copy(levels_.begin() + i + 1, levels_.begin() + size_, levels_.begin() + i);
+                    if (size_-- == CAPACITY)
+                    {
+                        complete_ = false;
+                    }
+                }
+                return;
+            }
+
+            if (cached)
+            {
+                levels_[i].total_volume = level.volume();
+                levels_[i].order_count = static_cast<uint32_t>(level.order_count());
+                return;
+            }
+
+            // New level: insert it if it ranks within what the cache covers
+            if (i == CAPACITY || (i == size_ && !complete_))
+            {
+                return;
+            }
+            const size_t end = std::min(size_, CAPACITY - 1);
+            std::copy_backward(levels_.begin() + i, levels_.begin() + end, levels_.begin() + end + 1);
+            levels_[i] = PriceLevel(price, level.volume(), static_cast<uint32_t>(level.order_count()));
+            size_ = end + 1;
+            if (size_ == CAPACITY)
+            {
+                complete_ = true; // Everything ranking above the tail is cached
+            }
+        }
+
+        // Rebuild from the level store if removals left the cache short
+        template <typename Levels>
+        void refill_if_needed(const Levels &levels)
+        {
+            if (complete_)
+            {
+                return;
+            }
+            size_ = 0;
+            levels.for_each_level([this](const PriceLevelImpl &level)
+                                  {
+                levels_[size_++] = PriceLevel(level.price(), level.volume(),
+                                              static_cast<uint32_t>(level.order_count()));
+                return size_ < CAPACITY; });
+            complete_ = true;
+        }
+
+        // Copy up to n cached levels into out, returning how many were copied
+        uint32_t copy_to(std::array<PriceLevel, CAPACITY> &out, size_t n) const
+        {
+            const size_t count = std::min(n, size_);
+            std::copy(levels_.begin(), levels_.begin() + count, out.begin());
+            return static_cast<uint32_t>(count);
+        }
+
+        // Drop the cached levels after a bulk change; the next query refills
+        void invalidate()
+        {
+            size_ = 0;
+            complete_ = false;
+        }
+
+        void clear()
+        {
+            size_ = 0;
+            complete_ = true;
+        }
+    };
+
+    // One side of the book: resting levels, their depth cache and the stops
+    // that will enter on this side. Everything that differs between bids
+    // and asks (level ordering, which way a limit crosses, which way stops
+    // trigger) is a compile-time property of S, so code templated on the
+    // side compiles to a separate branch-free path for each.
+    template <Side S, template <typename> class Levels>
+    struct BookSide
+    {
+        static constexpr bool IS_BUY = (S == Side::BUY);
+        static constexpr Side OPPOSITE = IS_BUY ? Side::SELL : Side::BUY;
+
+        // Resting levels, best first: highest bid, lowest ask
+        using LevelOrder = std::conditional_t<IS_BUY, std::greater<int64_t>, std::less<int64_t>>;
+
+        // Stops, first to trigger first: buy stops fire as the market rises,
+        // so the lowest trigger leads; sell stops the reverse
+        using StopOrder = std::conditional_t<IS_BUY, std::less<int64_t>, std::greater<int64_t>>;
+
+        // Limit a market order on this side uses so it crosses every level
+        static constexpr int64_t MARKET_PRICE = IS_BUY ? std::numeric_limits<int64_t>::max()
+                                                       : std::numeric_limits<int64_t>::min();
+
+        // True if an order on this side limited at `limit` trades against a
+        // resting level at `level_price`
+        static constexpr bool crosses(int64_t limit, int64_t level_price)
+        {
+            return IS_BUY ? limit >= level_price : limit <= level_price;
+        }
+
+        // True if a stop on this side triggered at `trigger` fires after
+        // trades printed between `low` and `high`
+        static constexpr bool stop_reached(int64_t trigger, int64_t low, int64_t high)
+        {
+            return IS_BUY ? trigger <= high : trigger >= low;
+        }
+
+        Levels<LevelOrder> levels;
+        MapLevels<StopOrder> stops;
+
+        // Top-of-book levels for depth(); refilled lazily, hence mutable
+        mutable DepthCache<LevelOrder> depth;
+
+        // Market orders collected during an auction, ahead of every level
+        PriceLevelImpl auction_market;
+
+        BookSide(const OrderBookConfig &config, LevelIndex *level_index)
+            : levels(config, level_index), stops(config, level_index) {}
+
+        void clear()
+        {
+            levels.clear();
+            stops.clear();
+            depth.clear();
+            auction_market = PriceLevelImpl();
+        }
+    };
+
+    template <Side S>
+    using SideTag = std::integral_constant<Side, S>;
+
+    // Call fn with the side as a compile-time constant. This is the one
+    // runtime branch on Side for each public operation.
+    template <typename Fn>
+    decltype(auto) dispatch(Side side, Fn &&fn)
+    {
+        if (side == Side::BUY)
+        {
+            return fn(SideTag<Side::BUY>{});
+        }
+        return fn(SideTag<Side::SELL>{});
+    }
+
+    // Checkpoint image of one book: this header, `level_count` level
+    // entries, `order_count` order records (remaining quantity, in level
+    // order, so record i becomes pool handle i on restore) and finally
+    // `index_capacity` slots of the id index with handles renumbered to
+    // match. Fixed-width fields only; read with memcpy, never cast in place.
+    struct CheckpointHeader
+    {
+        static constexpr uint64_t MAGIC = 0x314B4F4F42434D4Dull; // "MMCBOOK1"
+
+        uint64_t magic{MAGIC};
+        uint64_t symbol_id{0};
+        uint64_t next_trade_id{1};
+        int64_t last_trade_price{0};
+        uint64_t level_count{0};
+        uint64_t order_count{0};
+        uint64_t index_capacity{0};
+        uint8_t has_last_trade{0};
+        uint8_t in_auction{0};
+        uint8_t reserved[6]{};
+    };
+
+    // Which queue of a side a checkpoint level entry restores into
+    enum class CheckpointQueue : uint8_t
+    {
+        LEVEL = 0,
+        STOP = 1,
+        AUCTION_MARKET = 2
+    };
+
+    // A level or queue of the image; its orders follow the previous entry's
+    struct CheckpointLevel
+    {
+        int64_t price{0};
+        uint32_t order_count{0};
+        Side side{Side::BUY};
+        CheckpointQueue queue{CheckpointQueue::LEVEL};
+        uint16_t reserved{0};
+    };
+
+    static_assert(sizeof(CheckpointHeader) == 64 && sizeof(CheckpointLevel) == 16,
+                  "Checkpoint layout is part of the file format");
+
+    // OrderBook implementation, parameterised on how price levels are stored
+    template <template <typename> class Levels>
+    class OrderBookImpl : public IOrderBook
+    {
+    private:
+        uint64_t symbol_id_;
+
+        // Storage for resting orders; every node in the book lives here,
+        // with its full order record and current level in the matching
+        // slots of orders_ and level_of_
+        OrderPool pool_;
+        OrderColumn orders_;
+        LevelIndex level_of_;
+
+        BookSide<Side::BUY, Levels> bids_;
+        BookSide<Side::SELL, Levels> asks_;
+
+        // Order ID -> pool handle of the resting order; the handle leads
+        // straight to the node for O(1) cancel
+        utils::FlatIdMap<uint32_t> order_map_;
+
+        // Stops that have fired and are waiting to execute, in release order
+        PriceLevelImpl triggered_;
+
+        // Deadlines of resting GTD orders by pool handle, tagged with the
+        // order id. Fills do not disarm the timer: a stale timer is skipped
+        // when it fires, and re-armed if its handle is reused by another
+        // GTD order, which keeps the match path free of wheel updates.
+        utils::TimerWheel expiry_;
+
+        // Every resting order with a non-zero client_id is on its client's
+        // intrusive list: client_index_ maps the id to a slot in
+        // client_heads_, and client_links_ holds the list links per handle
+        ClientColumn client_links_;
+        utils::FlatIdMap<uint32_t> client_index_;
+        std::vector<uint32_t> client_heads_;
+
+        // Handles released by the mass cancel in progress
+        std::vector<uint32_t> cancelled_handles_;
+
+        // Every resting DAY order is on one intrusive list, so the end of
+        // session purge visits just those orders
+        DayColumn day_links_;
+        uint32_t day_head_{DayLink::NONE};
+        size_t day_orders_{0};
+
+        std::optional<int64_t> last_trade_price_;
+
+        // Collecting orders for a call auction instead of matching
+        bool in_auction_{false};
+
+        // Reusable arrays for uncross(): executable level prices and volumes
+        // per side, then merged into one ascending price grid holding
+        // cumulative demand and supply at each candidate price
+        struct AuctionScratch
+        {
+            std::vector<int64_t> bid_price, ask_price, price;
+            std::vector<uint64_t> bid_volume, ask_volume, demand, supply;
+        };
+        AuctionScratch auction_;
+
+        // Trade ID generator
+        uint64_t next_trade_id_{1};
+
+        // Pinned event time for trade and requeue timestamps, 0 = clock
+        uint64_t clock_ns_{0};
+
+        template <Side S>
+        auto &side()
+        {
+            if constexpr (S == Side::BUY)
+            {
+                return bids_;
+            }
+            else
+            {
+                return asks_;
+            }
+        }
+
+        template <Side S>
+        const auto &side() const
+        {
+            if constexpr (S == Side::BUY)
+            {
+                return bids_;
+            }
+            else
+            {
+                return asks_;
+            }
+        }
+
+        // Helper to generate trade
+        Trade generate_trade(const Order &aggressive_order, uint64_t passive_order_id,
+                             uint32_t quantity, int64_t price)
+        {
+            if (clock_ns_ != 0)
+            {
+                return Trade(next_trade_id_++, aggressive_order, passive_order_id, price, quantity, clock_ns_);
+            }
+            return Trade(next_trade_id_++, aggressive_order, passive_order_id, price, quantity);
+        }
+
+        // Take a pool slot for `order` and record it in the order column
+        OrderNode *allocate_node(const Order &order)
+        {
+            const auto handle = pool_.allocate(order.order_id, order.quantity);
+            orders_.reserve(pool_.capacity());
+            level_of_.reserve(pool_.capacity());
+            orders_[handle] = order;
+            if (order.tif == TimeInForce::DAY)
+            {
+                day_links_.reserve(pool_.capacity());
+                track_day(handle);
+            }
+            client_links_.reserve(pool_.capacity());
+            track_client(handle, order.client_id);
+
+            OrderNode *node = &pool_[handle];
+            node->handle = handle;
+            return node;
+        }
+
+        // Put a new resting order at the head of its client's list
+        void track_client(uint32_t handle, uint64_t client_id)
+        {
+            ClientLink &link = client_links_[handle];
+            if (client_id == 0)
+            {
+                link.client = ClientLink::NONE;
+                return;
+            }
+
+            const uint32_t *slot = client_index_.find(client_id);
+            if (!slot)
+            {
+                client_index_.insert(client_id, static_cast<uint32_t>(client_heads_.size()));
+                client_heads_.push_back(ClientLink::NONE);
+                slot = client_index_.find(client_id);
+            }
+
+            uint32_t &head = client_heads_[*slot];
+            link.client = *slot;
+            link.prev = ClientLink::NONE;
+            link.next = head;
+            if (head != ClientLink::NONE)
+            {
+                client_links_[head].prev = handle;
+            }
+            head = handle;
+        }
+
+        // Put a new resting DAY order at the head of the DAY list
+        void track_day(uint32_t handle)
+        {
+            DayLink &link = day_links_[handle];
+            link.prev = DayLink::NONE;
+            link.next = day_head_;
+            if (day_head_ != DayLink::NONE)
+            {
+                day_links_[day_head_].prev = handle;
+            }
+            day_head_ = handle;
+            ++day_orders_;
+        }
+
+        void untrack_day(uint32_t handle)
+        {
+            const DayLink &link = day_links_[handle];
+            if (link.prev != DayLink::NONE)
+            {
+                day_links_[link.prev].next = link.next;
+            }
+            else
+            {
+                day_head_ = link.next;
+            }
+            if (link.next != DayLink::NONE)
+            {
+                day_links_[link.next].prev = link.prev;
+            }
+            --day_orders_;
+        }
+
+        // Return a node's slot to the pool, taking it off its lists
+        void release_node(uint32_t handle)
+        {
+            if (orders_[handle].tif == TimeInForce::DAY)
+            {
+                untrack_day(handle);
+            }
+            untrack_client(handle);
+            pool_.release(handle);
+        }
+
+        void untrack_client(uint32_t handle)
+        {
+            if (!client_heads_.empty())
+            {
+                const ClientLink &link = client_links_[handle];
+                if (link.client != ClientLink::NONE)
+                {
+                    if (link.prev != ClientLink::NONE)
+                    {
+                        client_links_[link.prev].next = link.next;
+                    }
+                    else
+                    {
+                        client_heads_[link.client] = link.next;
+                    }
+                    if (link.next != ClientLink::NONE)
+                    {
+                        client_links_[link.next].prev = link.prev;
+                    }
+                }
+            }
+        }
+
+        // Full record of a resting order with its live remaining quantity
+        Order resting_order(const OrderNode *node) const
+        {
+            Order order = orders_[node->handle];
+            order.quantity = node->quantity;
+            return order;
+        }
+
+        // Match an incoming order on side S against the opposite side
+        template <Side S>
+        void match(Order *order, std::vector<Trade> &trades)
+        {
+            auto &passive = side<BookSide<S, Levels>::OPPOSITE>();
+
+            while (order->quantity > 0)
+            {
+                PriceLevelImpl *level = passive.levels.best();
+                if (!level)
+                {
+                    break; // Opposite side is empty
+                }
+                const int64_t level_price = level->price();
+
+                // Check if the order crosses the spread
+                if (!BookSide<S, Levels>::crosses(order->price, level_price))
+                {
+                    break; // No match possible
+                }
+
+                auto *resting = level->peek_front();
+                if (!resting)
+                {
+                    passive.levels.erase(level);
+                    continue;
+                }
+
+                // Calculate match quantity
+                uint32_t match_quantity = std::min(order->quantity, resting->quantity);
+
+                // Generate trade at passive order price (price-time priority)
+                trades.push_back(generate_trade(*order, resting->order_id, match_quantity, level_price));
+
+                order->quantity -= match_quantity;
+                fill_front<BookSide<S, Levels>::OPPOSITE>(level, resting, match_quantity);
+            }
+        }
+
+        // Take `quantity` off the front order of `level` on side S, removing
+        // the order once it is filled and the level once it is empty
+        template <Side S>
+        void fill_front(PriceLevelImpl *level, OrderNode *node, uint32_t quantity)
+        {
+            auto &own = side<S>();
+            node->quantity -= quantity;
+
+            if (node->quantity == 0)
+            {
+                level->remove_front_after_fill(quantity);
+                order_map_.erase(node->order_id);
+                release_node(node->handle);
+            }
+            else
+            {
+                level->update_volume_after_partial_fill(quantity);
+            }
+
+            if (level == &own.auction_market)
+            {
+                return; // Not a price level
+            }
+            own.depth.update(*level);
+            if (level->empty())
+            {
+                own.levels.erase(level);
+            }
+        }
+
+        // True if the opposite side holds at least the order's quantity at
+        // prices it crosses. Walks cumulative level volume only; the book is
+        // not touched.
+        template <Side S>
+        bool can_fill(const Order &order) const
+        {
+            uint64_t available = 0;
+            side<BookSide<S, Levels>::OPPOSITE>().levels.for_each_level(
+                [&](const PriceLevelImpl &level)
+                {
+                    if (!BookSide<S, Levels>::crosses(order.price, level.price()))
+                    {
+                        return false;
+                    }
+                    available += level.volume();
+                    return available < order.quantity;
+                });
+            return available >= order.quantity;
+        }
+
+        // Append a node to the back of the level for `price`
+        template <Side S>
+        void link_to_level(OrderNode *node, int64_t price)
+        {
+            auto &own = side<S>();
+            PriceLevelImpl *level = own.levels.get_or_create(price);
+            level->add_order(node);
+            level_of_[node->handle] = level;
+            own.depth.update(*level);
+        }
+
+        static bool is_stop(const Order &order)
+        {
+            return order.type == OrderType::STOP || order.type == OrderType::STOP_LIMIT;
+        }
+
+        // Take a node out of its level, dropping the level if it empties.
+        // Bulk removals skip the depth update and invalidate the cache once.
+        template <Side S>
+        void unlink_from_level(OrderNode *node, const Order &record, bool update_depth = true)
+        {
+            auto &own = side<S>();
+            PriceLevelImpl *level = level_of_[node->handle];
+
+            if (is_stop(record))
+            {
+                level->remove_order(node);
+                if (level->empty())
+                {
+                    own.stops.erase(level);
+                }
+                return;
+            }
+
+            level->remove_order(node);
+            if (level == &own.auction_market)
+            {
+                return;
+            }
+            if (update_depth)
+            {
+                own.depth.update(*level);
+            }
+            if (level->empty())
+            {
+                own.levels.erase(level);
+            }
+        }
+
+        // Validate, match and rest a non-stop order
+        template <Side S>
+        void execute(const Order &incoming, std::vector<Trade> &trades)
+        {
+            const bool is_market = incoming.type == OrderType::MARKET;
+
+            // Validate order; market orders carry no price
+            if (incoming.quantity == 0 || (!is_market && incoming.price <= 0) ||
+                (incoming.tif == TimeInForce::GTD && incoming.expire_time_ns == 0))
+            {
+                return; // Invalid order
+            }
+
+            // Check for duplicate order ID
+            if (order_map_.contains(incoming.order_id))
+            {
+                return; // Duplicate order ID
+            }
+
+            if (in_auction_)
+            {
+                collect<S>(incoming);
+                return;
+            }
+
+            // A market order crosses every level on the opposite side
+            Order order = incoming;
+            if (is_market)
+            {
+                order.price = BookSide<S, Levels>::MARKET_PRICE;
+            }
+
+            // Fill or kill: reject up front unless the whole quantity is available
+            if (order.tif == TimeInForce::FOK && !can_fill<S>(order))
+            {
+                return;
+            }
+
+            match<S>(&order, trades);
+
+            // Rest the remainder unless the order is immediate-only
+            const bool immediate = is_market || order.tif == TimeInForce::IOC ||
+                                   order.tif == TimeInForce::FOK;
+            if (order.quantity > 0 && !immediate)
+            {
+                add_to_book<S>(order);
+            }
+        }
+
+        // Rest an order for the coming uncross without matching it
+        template <Side S>
+        void collect(const Order &order)
+        {
+            if (order.tif == TimeInForce::IOC || order.tif == TimeInForce::FOK)
+            {
+                return; // Nothing to execute against until the uncross
+            }
+            if (order.type != OrderType::MARKET)
+            {
+                add_to_book<S>(order);
+                return;
+            }
+
+            OrderNode *node = allocate_node(order);
+            side<S>().auction_market.add_order(node);
+            level_of_[node->handle] = &side<S>().auction_market;
+            order_map_.insert(order.order_id, node->handle);
+        }
+
+        // Queue a stop order by trigger price until the market reaches it
+        template <Side S>
+        void park_stop(const Order &order)
+        {
+            const bool valid = order.quantity > 0 && order.stop_price > 0 &&
+                               (order.type == OrderType::STOP || order.price > 0) &&
+                               order.tif != TimeInForce::GTD;
+            if (!valid || order_map_.contains(order.order_id))
+            {
+                return;
+            }
+
+            OrderNode *node = allocate_node(order);
+            PriceLevelImpl *level = side<S>().stops.get_or_create(order.stop_price);
+            level->add_order(node);
+            level_of_[node->handle] = level;
+            order_map_.insert(order.order_id, node->handle);
+
+            // A stop whose trigger has already traded fires straight away
+            if (last_trade_price_)
+            {
+                trigger_stops(*last_trade_price_, *last_trade_price_);
+            }
+        }
+
+        // Move every stop level at the front of side S whose trigger has
+        // been reached onto the triggered queue, keeping FIFO order within
+        // each trigger price
+        template <Side S>
+        void drain_stops(int64_t low, int64_t high)
+        {
+            auto &stops = side<S>().stops;
+            while (PriceLevelImpl *level = stops.best())
+            {
+                if (!BookSide<S, Levels>::stop_reached(level->price(), low, high))
+                {
+                    return;
+                }
+                while (OrderNode *node = level->peek_front())
+                {
+                    level->remove_order(node);
+                    triggered_.add_order(node);
+                }
+                stops.erase(level);
+            }
+        }
+
+        // Fire stops crossed by trades printed between `low` and `high`
+        void trigger_stops(int64_t low, int64_t high)
+        {
+            drain_stops<Side::BUY>(low, high);
+            drain_stops<Side::SELL>(low, high);
+        }
+
+        // Execute triggered stops until no new trade triggers any more.
+        // Trades from index `scanned` onwards have not been checked yet;
+        // cascades are handled by looping rather than recursing.
+        // Returns the number of stops released.
+        size_t release_triggered_stops(size_t scanned, std::vector<Trade> &trades)
+        {
+            size_t released = 0;
+            for (;;)
+            {
+                if (scanned < trades.size())
+                {
+                    int64_t low = trades[scanned].price;
+                    int64_t high = low;
+                    for (size_t i = scanned + 1; i < trades.size(); ++i)
+                    {
+                        low = std::min(low, trades[i].price);
+                        high = std::max(high, trades[i].price);
+                    }
+                    last_trade_price_ = trades.back().price;
+                    scanned = trades.size();
+                    trigger_stops(low, high);
+                }
+
+                OrderNode *node = triggered_.peek_front();
+                if (!node)
+                {
+                    return released;
+                }
+                ++released;
+
+                // A stop becomes a market order, a stop-limit a limit order
+                triggered_.remove_order(node);
+                Order order = resting_order(node);
+                order_map_.erase(order.order_id);
+                release_node(node->handle);
+
+                order.type = (order.type == OrderType::STOP) ? OrderType::MARKET : OrderType::LIMIT;
+                dispatch(order.side, [&](auto s)
+                         { execute<decltype(s)::value>(order, trades); });
+            }
+        }
+
+        // Add order to the appropriate level
+        template <Side S>
+        void add_to_book(const Order &order)
+        {
+            OrderNode *node = allocate_node(order);
+            link_to_level<S>(node, order.price);
+            order_map_.insert(order.order_id, node->handle);
+            if (order.tif == TimeInForce::GTD)
+            {
+                expiry_.reserve(pool_.capacity());
+                expiry_.schedule(node->handle, order.expire_time_ns, order.order_id);
+            }
+        }
+
+        // Drop every order and level without visiting them one by one
+        void release_all_orders()
+        {
+            bids_.clear();
+            asks_.clear();
+            triggered_ = PriceLevelImpl();
+            expiry_.clear();
+            order_map_.clear();
+            pool_.reset();
+            day_head_ = DayLink::NONE;
+            day_orders_ = 0;
+            std::fill(client_heads_.begin(), client_heads_.end(), ClientLink::NONE);
+        }
+
+        // Remove a resting order found by walking a list rather than by id
+        // (its level or queue has already been dealt with by the caller)
+        void forget(OrderNode *node)
+        {
+            order_map_.erase(node->order_id);
+            expiry_.cancel(node->handle);
+            release_node(node->handle);
+        }
+
+        // Cancel every order on side S, then drop its levels wholesale
+        template <Side S>
+        size_t cancel_side()
+        {
+            auto &own = side<S>();
+            size_t cancelled = 0;
+            auto forget_level = [&](const PriceLevelImpl &level)
             {
-                // The order has already been filled, so we subtract the filled quantity
-                total_volume_ -= filled_quantity;
-                orders_.pop();
-            }
+                for (OrderNode *node = level.peek_front(); node;)
+                {
+                    OrderNode *next = node->next;
+                    forget(node);
+                    node = next;
+                    ++cancelled;
+                }
+                return true;
+            };
+            own.levels.for_each_level(forget_level);
+            own.stops.for_each_level(forget_level);
+            forget_level(own.auction_market);
+            own.clear();
+            return cancelled;
         }
 
-        bool remove_order(uint64_t order_id)
+        // Cancel a client's orders by walking its list
+        size_t cancel_client(uint64_t client_id, std::optional<Side> only)
         {
-            std::queue<std::shared_ptr<Order>> temp_queue;
-            bool found = false;
+            const uint32_t *slot = client_index_.find(client_id);
+            if (!slot)
+            {
+                return 0;
+            }
 
-            while (!orders_.empty())
+            // Detach the whole list and re-thread only the orders that stay,
+            // so cancelled orders need no list unlinking
+            cancelled_handles_.clear();
+            uint32_t handle = client_heads_[*slot];
+            client_heads_[*slot] = ClientLink::NONE;
+            while (handle != ClientLink::NONE)
             {
-                auto order = orders_.front();
-                orders_.pop();
+                ClientLink &link = client_links_[handle];
+                const uint32_t next = link.next;
+                const Order &record = orders_[handle];
+                if (only && record.side != *only)
+                {
+                    track_client(handle, client_id);
+                    handle = next;
+                    continue;
+                }
 
-                if (order->order_id == order_id)
+                OrderNode *node = &pool_[handle];
+                dispatch(record.side, [&](auto s)
+                         { unlink_from_level<decltype(s)::value>(node, record, false); });
+                if (record.tif == TimeInForce::GTD)
                 {
-                    total_volume_ -= order->quantity;
-                    found = true;
+                    expiry_.cancel(handle);
                 }
-                else
+                else if (record.tif == TimeInForce::DAY)
                 {
-                    temp_queue.push(order);
+                    untrack_day(handle);
                 }
+                link.client = ClientLink::CANCELLED;
+                pool_.release(handle);
+                cancelled_handles_.push_back(handle);
+                handle = next;
             }
+            bids_.depth.invalidate();
+            asks_.depth.invalidate();
 
-            orders_ = std::move(temp_queue);
-            return found;
+            // A large share of the book is cheaper to drop from the id index
+            // in one sweep of the table than by one probe per order
+            if (cancelled_handles_.size() * 8 >= order_map_.size())
+            {
+                order_map_.erase_if([&](uint64_t, uint32_t h)
+                                    { return client_links_[h].client == ClientLink::CANCELLED; });
+            }
+            else
+            {
+                for (uint32_t h : cancelled_handles_)
+                {
+                    order_map_.erase(orders_[h].order_id);
+                }
+            }
+            return cancelled_handles_.size();
         }
 
-        void update_front_quantity(uint32_t new_quantity)
+        template <Side S>
+        ModifyPath modify_impl(OrderNode *node, int64_t new_price, uint32_t new_quantity,
+                               std::vector<Trade> &trades, Order *result)
         {
-            if (!orders_.empty())
+            Order &record = orders_[node->handle];
+
+            if (is_stop(record) || record.type == OrderType::MARKET)
             {
-                auto &front_order = orders_.front();
-                // Update total volume: subtract old quantity, add new quantity
-                total_volume_ = total_volume_ - front_order->quantity + new_quantity;
-                // Note: Don't update front_order->quantity here as it's already been updated
+                // Untriggered stops and auction market orders have no limit
+                // to change; they are cancel/replace only
+                return ModifyPath::REJECTED;
             }
-        }
 
-        void update_volume_after_partial_fill(uint32_t filled_quantity)
-        {
-            // Simply subtract the filled quantity from total volume
-            total_volume_ -= filled_quantity;
-        }
+            if (new_price == record.price && new_quantity <= node->quantity)
+            {
+                // Fast path: shrink in place and keep queue position
+                PriceLevelImpl *level = level_of_[node->handle];
+                level->update_quantity(node, new_quantity);
+                side<S>().depth.update(*level);
+                *result = resting_order(node);
+                return ModifyPath::IN_PLACE;
+            }
 
-        bool empty() const { return orders_.empty(); }
-        size_t order_count() const { return orders_.size(); }
-        uint32_t volume() const { return total_volume_; }
-        int64_t price() const { return price_; }
-    };
+            // Any other change loses time priority; the node is reused
+            unlink_from_level<S>(node, record);
+            node->quantity = new_quantity;
+            record.quantity = new_quantity;
+            record.timestamp_ns = clock_ns_ != 0
+                                      ? clock_ns_
+                                      : std::chrono::steady_clock::now().time_since_epoch().count();
 
-    // OrderBook implementation
-    class OrderBookImpl : public IOrderBook
-    {
-    private:
-        uint64_t symbol_id_;
+            if (new_price == record.price)
+            {
+                link_to_level<S>(node, record.price);
+                *result = record;
+                return ModifyPath::REQUEUED;
+            }
 
-        // Buy orders: price -> level (sorted high to low)
-        std::map<int64_t, std::unique_ptr<PriceLevelImpl>, std::greater<int64_t>> buy_levels_;
+            record.price = new_price;
+            const size_t first_trade = trades.size();
+            if (!in_auction_)
+            {
+                match<S>(&record, trades);
+            }
+            node->quantity = record.quantity;
+            *result = record;
 
-        // Sell orders: price -> level (sorted low to high)
-        std::map<int64_t, std::unique_ptr<PriceLevelImpl>, std::less<int64_t>> sell_levels_;
+            if (record.quantity > 0)
+            {
+                link_to_level<S>(node, record.price);
+            }
+            else
+            {
+                order_map_.erase(record.order_id);
+                release_node(node->handle);
+            }
 
-        // Order ID -> Order mapping for fast lookup
-        std::unordered_map<uint64_t, std::shared_ptr<Order>> order_map_;
+            release_triggered_stops(first_trade, trades);
+            return ModifyPath::REPRICED;
+        }
 
-        // Trade ID generator
-        uint64_t next_trade_id_{1};
+        ModifyPath modify_impl(uint64_t order_id, int64_t new_price, uint32_t new_quantity,
+                               std::vector<Trade> &trades, Order *result)
+        {
+            const uint32_t *found = order_map_.find(order_id);
+            if (!found)
+            {
+                return ModifyPath::NOT_FOUND;
+            }
+            if (new_price <= 0)
+            {
+                return ModifyPath::REJECTED;
+            }
 
-        // Helper to generate trade
-        Trade generate_trade(const Order &aggressive_order, const Order &passive_order,
-                             uint32_t quantity, int64_t price)
+            OrderNode *node = &pool_[*found];
+            if (new_quantity == 0)
+            {
+                *result = resting_order(node);
+                result->quantity = 0;
+                cancel_order(order_id);
+                return ModifyPath::CANCELLED;
+            }
+
+            return dispatch(orders_[node->handle].side, [&](auto s)
+                            { return modify_impl<decltype(s)::value>(node, new_price, new_quantity,
+                                                                     trades, result); });
+        }
+
+        // Append the price and volume of each level on side S that could
+        // execute in the auction, best first, stopping at the first level
+        // beyond `bound`
+        template <Side S>
+        void gather_levels(int64_t bound, std::vector<int64_t> &prices,
+                           std::vector<uint64_t> &volumes)
         {
-            return Trade(next_trade_id_++, aggressive_order, passive_order, price, quantity);
+            prices.clear();
+            volumes.clear();
+            side<S>().levels.for_each_level(
+                [&](const PriceLevelImpl &level)
+                {
+                    if (!BookSide<S, Levels>::crosses(level.price(), bound))
+                    {
+                        return false;
+                    }
+                    prices.push_back(level.price());
+                    volumes.push_back(level.volume());
+                    return true;
+                });
         }
 
-        // Match a buy order against sell orders
-        std::vector<Trade> match_buy_order(std::shared_ptr<Order> buy_order)
+        // Find the auction price. Candidate prices are the limits of levels
+        // that can execute; demand at a price is every bid at or above it
+        // and supply every ask at or below it, plus the market orders. Both
+        // are built as one prefix and one suffix sum over the merged grid,
+        // then the tie-break rules are applied as flat reductions over it.
+        AuctionResult equilibrium(int64_t reference_price)
         {
-            std::vector<Trade> trades;
+            constexpr int64_t NO_PRICE = std::numeric_limits<int64_t>::max();
+            AuctionResult result;
+            AuctionScratch &a = auction_;
+
+            const uint64_t market_demand = bids_.auction_market.volume();
+            const uint64_t market_supply = asks_.auction_market.volume();
+            const PriceLevelImpl *top_bid = bids_.levels.best();
+            const PriceLevelImpl *top_ask = asks_.levels.best();
+            if ((!top_bid && market_demand == 0) || (!top_ask && market_supply == 0))
+            {
+                return result; // One side has nothing to trade
+            }
 
-            while (buy_order->quantity > 0 && !sell_levels_.empty())
+            // Without market orders on the other side, a level can only
+            // execute if it reaches that side's best limit
+            const int64_t bid_bound = (top_ask && market_supply == 0)
+                                          ? top_ask->price()
+                                          : std::numeric_limits<int64_t>::min();
+            const int64_t ask_bound = (top_bid && market_demand == 0)
+                                          ? top_bid->price()
+                                          : std::numeric_limits<int64_t>::max();
+            gather_levels<Side::BUY>(bid_bound, a.bid_price, a.bid_volume);
+            gather_levels<Side::SELL>(ask_bound, a.ask_price, a.ask_volume);
+
+            // Merge bids (gathered descending) and asks (ascending) into one
+            // ascending grid of per-price volume
+            a.price.clear();
+            a.demand.clear();
+            a.supply.clear();
+            size_t b = a.bid_price.size();
+            size_t s = 0;
+            while (b > 0 || s < a.ask_price.size())
             {
-                auto &[best_ask_price, best_ask_level] = *sell_levels_.begin();
+                const int64_t bid = (b > 0) ? a.bid_price[b - 1] : NO_PRICE;
+                const int64_t ask = (s < a.ask_price.size()) ? a.ask_price[s] : NO_PRICE;
+                const int64_t price = std::min(bid, ask);
+                a.price.push_back(price);
+                a.demand.push_back((bid == price) ? a.bid_volume[--b] : 0);
+                a.supply.push_back((ask == price) ? a.ask_volume[s++] : 0);
+            }
+            const size_t n = a.price.size();
 
-                // Check if buy price crosses the spread
-                if (buy_order->price < best_ask_price)
-                {
-                    break; // No match possible
-                }
+            if (reference_price <= 0 && last_trade_price_)
+            {
+                reference_price = *last_trade_price_;
+            }
 
-                auto sell_order = best_ask_level->peek_front();
-                if (!sell_order)
+            if (n == 0)
+            {
+                // Market orders only: they trade at the reference price
+                if (reference_price > 0 && market_demand > 0 && market_supply > 0)
                 {
-                    sell_levels_.erase(sell_levels_.begin());
-                    continue;
+                    result.price = reference_price;
+                    result.volume = std::min(market_demand, market_supply);
+                    result.imbalance = static_cast<int64_t>(market_demand - market_supply);
                 }
+                return result;
+            }
 
-                // Calculate match quantity
-                uint32_t match_quantity = std::min(buy_order->quantity, sell_order->quantity);
+            uint64_t cumulative = market_supply;
+            for (size_t i = 0; i < n; ++i)
+            {
+                cumulative += a.supply[i];
+                a.supply[i] = cumulative;
+            }
+            cumulative = market_demand;
+            for (size_t i = n; i-- > 0;)
+            {
+                cumulative += a.demand[i];
+                a.demand[i] = cumulative;
+            }
 
-                // Generate trade at passive order price (price-time priority)
-                trades.push_back(generate_trade(*buy_order, *sell_order, match_quantity, best_ask_price));
+            // 1. Maximum executable volume
+            uint64_t volume = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                volume = std::max(volume, std::min(a.demand[i], a.supply[i]));
+            }
+            if (volume == 0)
+            {
+                return result; // Book does not cross
+            }
 
-                // Update quantities
-                buy_order->quantity -= match_quantity;
-                sell_order->quantity -= match_quantity;
+            // 2. Minimum imbalance among the maximum-volume prices
+            auto gap = [&](size_t i)
+            {
+                return (a.demand[i] > a.supply[i]) ? a.demand[i] - a.supply[i]
+                                                   : a.supply[i] - a.demand[i];
+            };
+            uint64_t imbalance = std::numeric_limits<uint64_t>::max();
+            for (size_t i = 0; i < n; ++i)
+            {
+                const bool eligible = std::min(a.demand[i], a.supply[i]) == volume;
+                imbalance = std::min(imbalance, eligible ? gap(i) : std::numeric_limits<uint64_t>::max());
+            }
+            auto tied = [&](size_t i)
+            {
+                return std::min(a.demand[i], a.supply[i]) == volume && gap(i) == imbalance;
+            };
 
-                if (sell_order->quantity == 0)
+            // 3. Closest to the reference price, else to the middle of the
+            // tied range; the lower price wins an exact tie
+            if (reference_price <= 0)
+            {
+                int64_t low = NO_PRICE;
+                int64_t high = 0;
+                for (size_t i = 0; i < n; ++i)
                 {
-                    // Remove fully filled sell order
-                    order_map_.erase(sell_order->order_id);
-                    best_ask_level->remove_front_after_fill(match_quantity);
-
-                    if (best_ask_level->empty())
+                    if (tied(i))
                     {
-                        sell_levels_.erase(sell_levels_.begin());
+                        low = std::min(low, a.price[i]);
+                        high = std::max(high, a.price[i]);
                     }
                 }
-                else
+                reference_price = low + (high - low) / 2;
+            }
+            size_t chosen = n;
+            uint64_t distance = std::numeric_limits<uint64_t>::max();
+            for (size_t i = 0; i < n; ++i)
+            {
+                const int64_t offset = a.price[i] - reference_price;
+                const auto d = static_cast<uint64_t>(offset < 0 ? -offset : offset);
+                if (tied(i) && d < distance)
                 {
-                    // Update partially filled sell order
-                    best_ask_level->update_volume_after_partial_fill(match_quantity);
+                    distance = d;
+                    chosen = i;
                 }
             }
 
-            return trades;
+            result.price = a.price[chosen];
+            result.volume = volume;
+            result.imbalance = static_cast<int64_t>(a.demand[chosen] - a.supply[chosen]);
+            return result;
         }
 
-        // Match a sell order against buy orders
-        std::vector<Trade> match_sell_order(std::shared_ptr<Order> sell_order)
+        // Front order on side S in auction priority: market orders, then
+        // levels best first
+        template <Side S>
+        PriceLevelImpl *auction_front()
         {
-            std::vector<Trade> trades;
+            auto &own = side<S>();
+            return own.auction_market.empty() ? own.levels.best() : &own.auction_market;
+        }
 
-            while (sell_order->quantity > 0 && !buy_levels_.empty())
+        // Fill `result.volume` at the auction price, pairing bids and asks
+        // in price-time priority. An auction has no aggressor; each trade
+        // records the later of the two orders as the aggressive one.
+        void execute_auction(const AuctionResult &result, std::vector<Trade> &trades)
+        {
+            uint64_t remaining = result.volume;
+            while (remaining > 0)
             {
-                auto &[best_bid_price, best_bid_level] = *buy_levels_.begin();
-
-                // Check if sell price crosses the spread
-                if (sell_order->price > best_bid_price)
-                {
-                    break; // No match possible
-                }
+                PriceLevelImpl *bid_level = auction_front<Side::BUY>();
+                PriceLevelImpl *ask_level = auction_front<Side::SELL>();
+                OrderNode *bid = bid_level->peek_front();
+                OrderNode *ask = ask_level->peek_front();
+                const auto quantity = static_cast<uint32_t>(
+                    std::min<uint64_t>({bid->quantity, ask->quantity, remaining}));
+
+                const Order &buy = orders_[bid->handle];
+                const Order &sell = orders_[ask->handle];
+                trades.push_back(buy.timestamp_ns >= sell.timestamp_ns
+                                     ? generate_trade(buy, ask->order_id, quantity, result.price)
+                                     : generate_trade(sell, bid->order_id, quantity, result.price));
+
+                fill_front<Side::BUY>(bid_level, bid, quantity);
+                fill_front<Side::SELL>(ask_level, ask, quantity);
+                remaining -= quantity;
+            }
+        }
 
-                auto buy_order = best_bid_level->peek_front();
-                if (!buy_order)
-                {
-                    buy_levels_.erase(buy_levels_.begin());
-                    continue;
-                }
+        // Cancel market orders left over after an uncross; they never rest
+        template <Side S>
+        void drop_auction_market_orders()
+        {
+            PriceLevelImpl &queue = side<S>().auction_market;
+            while (OrderNode *node = queue.peek_front())
+            {
+                queue.remove_order(node);
+                order_map_.erase(node->order_id);
+                release_node(node->handle);
+            }
+        }
 
-                // Calculate match quantity
-                uint32_t match_quantity = std::min(sell_order->quantity, buy_order->quantity);
+        // Visit every non-empty level and queue of side S in checkpoint
+        // order as fn(level, queue): levels and stops best first, then
+        // auction market orders
+        template <Side S, typename Fn>
+        void for_each_queue(Fn &&fn) const
+        {
+            const auto &own = side<S>();
+            own.levels.for_each_level([&](const PriceLevelImpl &level)
+                                      { fn(level, CheckpointQueue::LEVEL); return true; });
+            own.stops.for_each_level([&](const PriceLevelImpl &level)
+                                     { fn(level, CheckpointQueue::STOP); return true; });
+            if (!own.auction_market.empty())
+            {
+                fn(own.auction_market, CheckpointQueue::AUCTION_MARKET);
+            }
+        }
 
-                // Generate trade at passive order price (price-time priority)
-                trades.push_back(generate_trade(*sell_order, *buy_order, match_quantity, best_bid_price));
+        // True if `order` can rest in the level or queue of `entry`: its
+        // side, a stop only among stops, a market order only in the
+        // auction queue, and keyed by the entry's price
+        static bool belongs_to(const Order &order, const CheckpointLevel &entry)
+        {
+            if (order.side != entry.side)
+            {
+                return false;
+            }
+            switch (entry.queue)
+            {
+            case CheckpointQueue::LEVEL:
+                return order.type == OrderType::LIMIT && order.price == entry.price;
+            case CheckpointQueue::STOP:
+                return is_stop(order) && order.stop_price == entry.price;
+            case CheckpointQueue::AUCTION_MARKET:
+                return order.type == OrderType::MARKET;
+            default:
+                return false;
+            }
+        }
 
-                // Update quantities
-                sell_order->quantity -= match_quantity;
-                buy_order->quantity -= match_quantity;
+        // Level or queue a checkpoint entry restores into, nullptr if invalid
+        template <Side S>
+        PriceLevelImpl *restore_target(const CheckpointLevel &entry)
+        {
+            auto &own = side<S>();
+            switch (entry.queue)
+            {
+            case CheckpointQueue::LEVEL:
+                return own.levels.get_or_create(entry.price);
+            case CheckpointQueue::STOP:
+                return own.stops.get_or_create(entry.price);
+            case CheckpointQueue::AUCTION_MARKET:
+                return &own.auction_market;
+            default:
+                return nullptr;
+            }
+        }
 
-                if (buy_order->quantity == 0)
+        // Rebuild the book from a validated image. Orders are allocated in
+        // record order from a pool reset after it has grown to size (growth
+        // puts new chunks at the head of the free list), so record i lands
+        // in handle i and the stored id index applies as is.
+        bool restore_orders(const CheckpointHeader &header, const std::byte *levels,
+                            const std::byte *records, const std::byte *index)
+        {
+            pool_.reserve(header.order_count);
+            pool_.reset();
+            day_head_ = DayLink::NONE;
+            day_orders_ = 0;
+            orders_.reserve(pool_.capacity());
+            level_of_.reserve(pool_.capacity());
+            client_links_.reserve(pool_.capacity());
+            day_links_.reserve(pool_.capacity());
+
+            uint64_t restored = 0;
+            for (uint64_t i = 0; i < header.level_count; ++i)
+            {
+                CheckpointLevel entry;
+                std::memcpy(&entry, levels + i * sizeof(CheckpointLevel), sizeof(entry));
+                if (entry.order_count == 0 || entry.order_count > header.order_count - restored)
+                {
+                    return false;
+                }
+                PriceLevelImpl *level = dispatch(entry.side, [&](auto s)
+                                                 { return restore_target<decltype(s)::value>(entry); });
+                if (!level)
                 {
-                    // Remove fully filled buy order
-                    order_map_.erase(buy_order->order_id);
-                    best_bid_level->remove_front_after_fill(match_quantity);
+                    return false;
+                }
 
-                    if (best_bid_level->empty())
+                for (uint32_t k = 0; k < entry.order_count; ++k, ++restored)
+                {
+                    Order order;
+                    std::memcpy(&order, records + restored * sizeof(Order), sizeof(Order));
+                    if (!belongs_to(order, entry))
                     {
-                        buy_levels_.erase(buy_levels_.begin());
+                        return false;
+                    }
+                    OrderNode *node = allocate_node(order);
+                    if (node->handle != restored)
+                    {
+                        return false;
+                    }
+                    level->add_order(node);
+                    level_of_[node->handle] = level;
+                    if (order.tif == TimeInForce::GTD)
+                    {
+                        expiry_.reserve(pool_.capacity());
+                        expiry_.schedule(node->handle, order.expire_time_ns, order.order_id);
                     }
                 }
-                else
-                {
-                    // Update partially filled buy order
-                    best_bid_level->update_volume_after_partial_fill(match_quantity);
-                }
+            }
+            if (restored != header.order_count)
+            {
+                return false;
             }
 
-            return trades;
-        }
+            // Levels were filled without touching the depth caches
+            bids_.depth.invalidate();
+            asks_.depth.invalidate();
 
-        // Add order to the appropriate level
-        void add_to_book(std::shared_ptr<Order> order)
-        {
-            if (order->side == Side::BUY)
+            using IndexSlot = utils::FlatIdMap<uint32_t>::Slot;
+            if (!order_map_.load_table(reinterpret_cast<const IndexSlot *>(index),
+                                       header.index_capacity, header.order_count))
             {
-                auto &level = buy_levels_[order->price];
-                if (!level)
-                {
-                    level = std::make_unique<PriceLevelImpl>(order->price);
-                }
-                level->add_order(order);
+                return false;
             }
-            else
+
+            // The table is well formed; it must also index exactly these
+            // records. Each id has to find its own handle, and with as many
+            // occupied slots as records that leaves no slot pointing
+            // anywhere else.
+            for (uint32_t handle = 0; handle < header.order_count; ++handle)
             {
-                auto &level = sell_levels_[order->price];
-                if (!level)
+                const uint32_t *found = order_map_.find(orders_[handle].order_id);
+                if (!found || *found != handle)
                 {
-                    level = std::make_unique<PriceLevelImpl>(order->price);
+                    return false;
                 }
-                level->add_order(order);
             }
+            return true;
+        }
+
+        template <Side S>
+        const PriceLevelImpl *find_level(int64_t price) const
+        {
+            return side<S>().levels.find(price);
+        }
 
-            order_map_[order->order_id] = order;
+        const PriceLevelImpl *find_level(int64_t price, Side s) const
+        {
+            return (s == Side::BUY) ? find_level<Side::BUY>(price) : find_level<Side::SELL>(price);
         }
 
     public:
-        explicit OrderBookImpl(uint64_t symbol_id) : symbol_id_(symbol_id) {}
+        OrderBookImpl(uint64_t symbol_id, const OrderBookConfig &config)
+            : symbol_id_(symbol_id), pool_(config.initial_order_capacity),
+              bids_(config, &level_of_), asks_(config, &level_of_),
+              order_map_(config.initial_order_capacity),
+              expiry_(config.expiry_tick_ns)
+        {
+            orders_.reserve(pool_.capacity());
+            level_of_.reserve(pool_.capacity());
+            expiry_.reserve(pool_.capacity());
+            client_links_.reserve(pool_.capacity());
+            day_links_.reserve(pool_.capacity());
+        }
+
+        size_t add_order(const Order &incoming, std::vector<Trade> &trades) override
+        {
+            const size_t first_trade = trades.size();
+            dispatch(incoming.side, [&](auto s)
+                     {
+                constexpr Side S = decltype(s)::value;
+                if (is_stop(incoming))
+                {
+                    park_stop<S>(incoming);
+                }
+                else
+                {
+                    execute<S>(incoming, trades);
+                } });
+
+            // Trades printed above, and by any stops they release, can
+            // trigger further stops
+            release_triggered_stops(first_trade, trades);
+            return trades.size() - first_trade;
+        }
 
-        std::vector<Trade> add_order(Order order) override
+        bool cancel_order(uint64_t order_id) override
         {
-            // Validate order
-            if (order.quantity == 0 || order.price <= 0)
+            auto handle = order_map_.extract(order_id);
+            if (!handle)
             {
-                return {}; // Invalid order
+                return false; // Order not found
             }
 
-            // Create shared pointer for the order
-            auto order_ptr = std::make_shared<Order>(std::move(order));
-
-            // Check for duplicate order ID
-            if (order_map_.find(order_ptr->order_id) != order_map_.end())
+            // Unlink from the price level FIFO in O(1)
+            OrderNode *node = &pool_[*handle];
+            const Order &record = orders_[*handle];
+            if (record.tif == TimeInForce::GTD)
             {
-                return {}; // Duplicate order ID
+                expiry_.cancel(*handle);
             }
+            dispatch(record.side, [&](auto s)
+                     { unlink_from_level<decltype(s)::value>(node, record); });
+            release_node(*handle);
+            return true;
+        }
 
-            // Match the order
+        std::optional<Order> modify_order(uint64_t order_id, int64_t new_price,
+                                          uint32_t new_quantity) override
+        {
             std::vector<Trade> trades;
-            if (order_ptr->side == Side::BUY)
+            Order result;
+            switch (modify_impl(order_id, new_price, new_quantity, trades, &result))
             {
-                trades = match_buy_order(order_ptr);
+            case ModifyPath::NOT_FOUND:
+            case ModifyPath::REJECTED:
+                return std::nullopt;
+            default:
+                return result;
             }
-            else
+        }
+
+        ModifyPath modify_order(uint64_t order_id, int64_t new_price,
+                                uint32_t new_quantity, std::vector<Trade> &trades) override
+        {
+            Order result;
+            return modify_impl(order_id, new_price, new_quantity, trades, &result);
+        }
+
+        void begin_auction() override
+        {
+            in_auction_ = true;
+        }
+
+        bool in_auction() const override
+        {
+            return in_auction_;
+        }
+
+        AuctionResult uncross(std::vector<Trade> &trades, int64_t reference_price, bool next_auction) override
+        {
+            const size_t first_trade = trades.size();
+            AuctionResult result = equilibrium(reference_price);
+            execute_auction(result, trades);
+            drop_auction_market_orders<Side::BUY>();
+            drop_auction_market_orders<Side::SELL>();
+            in_auction_ = next_auction;
+
+            // The auction print can trigger stops, which match normally or,
+            // in the next auction, are collected for it
+            const size_t released = release_triggered_stops(first_trade, trades);
+            if (next_auction)
+            {
+                result.held_stops = released;
+            }
+            return result;
+        }
+
+        size_t mass_cancel(uint64_t client_id, std::optional<Side> only) override
+        {
+            if (client_id != 0)
             {
-                trades = match_sell_order(order_ptr);
+                return cancel_client(client_id, only);
             }
 
-            // Add remaining quantity to book
-            if (order_ptr->quantity > 0)
+            size_t cancelled = 0;
+            if (!only || *only == Side::BUY)
+            {
+                cancelled += cancel_side<Side::BUY>();
+            }
+            if (!only || *only == Side::SELL)
             {
-                add_to_book(order_ptr);
+                cancelled += cancel_side<Side::SELL>();
             }
+            return cancelled;
+        }
 
-            return trades;
+        size_t expire_orders(uint64_t now_ns) override
+        {
+            size_t expired = 0;
+            expiry_.advance(now_ns, [&](uint32_t handle, uint64_t order_id)
+                            {
+                // Skip timers left behind by orders that have since filled
+                const uint32_t *found = order_map_.find(order_id);
+                if (found && *found == handle)
+                {
+                    cancel_order(order_id);
+                    ++expired;
+                } });
+            return expired;
         }
 
-        bool cancel_order(uint64_t order_id) override
+        size_t purge_day_orders() override
         {
-            auto it = order_map_.find(order_id);
-            if (it == order_map_.end())
+            const size_t purged = day_orders_;
+            if (purged == order_map_.size())
             {
-                return false; // Order not found
+                release_all_orders(); // Nothing else rests
+                return purged;
             }
 
-            auto order = it->second;
-            order_map_.erase(it);
+            // Walk the DAY list alone; DAY orders carry no expiry timer.
+            // When they are a large share of the book the id index is
+            // swept once instead of probed per order, as for mass cancel.
+            const bool sweep = purged * 8 >= order_map_.size();
+            for (uint32_t handle = day_head_; handle != DayLink::NONE;)
+            {
+                const uint32_t next = day_links_[handle].next;
+                const Order &record = orders_[handle];
+                OrderNode *node = &pool_[handle];
+                dispatch(record.side, [&](auto s)
+                         { unlink_from_level<decltype(s)::value>(node, record, false); });
+                if (!sweep)
+                {
+                    order_map_.erase(record.order_id);
+                }
+                untrack_client(handle);
+                pool_.release(handle);
+                handle = next;
+            }
+            day_head_ = DayLink::NONE;
+            day_orders_ = 0;
+            bids_.depth.invalidate();
+            asks_.depth.invalidate();
+
+            if (sweep)
+            {
+                order_map_.erase_if([&](uint64_t, uint32_t h)
+                                    { return orders_[h].tif == TimeInForce::DAY; });
+            }
+            return purged;
+        }
 
-            // Remove from price level
-            if (order->side == Side::BUY)
+        void write_checkpoint(std::ostream &out) const override
+        {
+            CheckpointHeader header;
+            header.symbol_id = symbol_id_;
+            header.next_trade_id = next_trade_id_;
+            header.has_last_trade = last_trade_price_.has_value();
+            header.last_trade_price = last_trade_price_.value_or(0);
+            header.in_auction = in_auction_;
+            header.order_count = order_map_.size();
+            header.index_capacity = order_map_.capacity();
+
+            // Number every order in the sequence it is written, which is
+            // the handle restore will give it
+            std::vector<CheckpointLevel> levels;
+            std::vector<uint32_t> renumbered(pool_.capacity());
+            uint32_t next_handle = 0;
+            auto number = [&](Side s)
             {
-                auto level_it = buy_levels_.find(order->price);
-                if (level_it != buy_levels_.end())
+                return [&, s](const PriceLevelImpl &level, CheckpointQueue queue)
                 {
-                    level_it->second->remove_order(order_id);
-                    if (level_it->second->empty())
+                    levels.push_back(CheckpointLevel{level.price(),
+                                                     static_cast<uint32_t>(level.order_count()), s, queue, 0});
+                    for (const OrderNode *node = level.peek_front(); node; node = node->next)
                     {
-                        buy_levels_.erase(level_it);
+                        renumbered[node->handle] = next_handle++;
                     }
+                };
+            };
+            for_each_queue<Side::BUY>(number(Side::BUY));
+            for_each_queue<Side::SELL>(number(Side::SELL));
+            header.level_count = levels.size();
+
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char *>(levels.data()),
+                      static_cast<std::streamsize>(levels.size() * sizeof(CheckpointLevel)));
+
+            auto write_records = [&](const PriceLevelImpl &level, CheckpointQueue)
+            {
+                for (const OrderNode *node = level.peek_front(); node; node = node->next)
+                {
+                    const Order order = resting_order(node);
+                    out.write(reinterpret_cast<const char *>(&order), sizeof(Order));
                 }
-            }
-            else
+            };
+            for_each_queue<Side::BUY>(write_records);
+            for_each_queue<Side::SELL>(write_records);
+
+            // The restored book loads the table as is, slot for slot, so
+            // the live table with its handles renumbered is its table.
+            // Written through a bounded heap buffer, not the stack.
+            using IndexSlot = utils::FlatIdMap<uint32_t>::Slot;
+            constexpr size_t BATCH = 4096;
+            std::vector<IndexSlot> batch(std::min<size_t>(BATCH, header.index_capacity));
+            const IndexSlot *table = order_map_.table();
+            for (size_t i = 0; i < header.index_capacity; i += BATCH)
             {
-                auto level_it = sell_levels_.find(order->price);
-                if (level_it != sell_levels_.end())
+                const size_t n = std::min<size_t>(BATCH, header.index_capacity - i);
+                for (size_t j = 0; j < n; ++j)
                 {
-                    level_it->second->remove_order(order_id);
-                    if (level_it->second->empty())
+                    batch[j] = table[i + j];
+                    if (batch[j].dist != 0)
                     {
-                        sell_levels_.erase(level_it);
+                        batch[j].value = renumbered[batch[j].value];
                     }
                 }
+                out.write(reinterpret_cast<const char *>(batch.data()),
+                          static_cast<std::streamsize>(n * sizeof(IndexSlot)));
             }
-
-            return true;
         }
 
-        std::optional<Order> modify_order(uint64_t order_id, int64_t new_price,
-                                          uint32_t new_quantity) override
+        size_t restore_checkpoint(const std::byte *data, size_t size) override
         {
-            auto it = order_map_.find(order_id);
-            if (it == order_map_.end())
+            clear();
+
+            CheckpointHeader header;
+            if (size < sizeof(header))
             {
-                return std::nullopt; // Order not found
+                return 0;
             }
-
-            auto old_order = *it->second;
-
-            // Cancel the old order
-            if (!cancel_order(order_id))
+            std::memcpy(&header, data, sizeof(header));
+
+            // Bound every count by the image size before multiplying
+            using IndexSlot = utils::FlatIdMap<uint32_t>::Slot;
+            const size_t body = size - sizeof(header);
+            if (header.magic != CheckpointHeader::MAGIC || header.symbol_id != symbol_id_ ||
+                header.level_count > body / sizeof(CheckpointLevel) ||
+                header.order_count > body / sizeof(Order) ||
+                header.order_count >= ClientLink::CANCELLED ||
+                header.index_capacity > body / sizeof(IndexSlot))
             {
-                return std::nullopt;
+                return 0;
+            }
+            const size_t levels_bytes = header.level_count * sizeof(CheckpointLevel);
+            const size_t records_bytes = header.order_count * sizeof(Order);
+            const size_t index_bytes = header.index_capacity * sizeof(IndexSlot);
+            if (levels_bytes + records_bytes + index_bytes > body)
+            {
+                return 0;
             }
 
-            // Create new order with same ID but new price/quantity
-            Order new_order = old_order;
-            new_order.price = new_price;
-            new_order.quantity = new_quantity;
-            new_order.timestamp_ns = std::chrono::steady_clock::now().time_since_epoch().count();
-
-            // Add the modified order (this will also match it)
-            add_order(new_order);
+            const std::byte *levels = data + sizeof(header);
+            const std::byte *records = levels + levels_bytes;
+            const std::byte *index = records + records_bytes;
+            if (!restore_orders(header, levels, records, index))
+            {
+                clear();
+                return 0;
+            }
 
-            return new_order;
+            next_trade_id_ = header.next_trade_id;
+            if (header.has_last_trade)
+            {
+                last_trade_price_ = header.last_trade_price;
+            }
+            in_auction_ = header.in_auction != 0;
+            return sizeof(header) + levels_bytes + records_bytes + index_bytes;
         }
 
         std::optional<int64_t> best_bid() const override
         {
-            if (buy_levels_.empty())
+            const PriceLevelImpl *level = bids_.levels.best();
+            if (!level)
             {
                 return std::nullopt;
             }
-            return buy_levels_.begin()->first;
+            return level->price();
         }
 
         std::optional<int64_t> best_ask() const override
         {
-            if (sell_levels_.empty())
+            const PriceLevelImpl *level = asks_.levels.best();
+            if (!level)
             {
                 return std::nullopt;
             }
-            return sell_levels_.begin()->first;
+            return level->price();
         }
 
         uint32_t volume_at_price(int64_t price, Side side) const override
         {
-            if (side == Side::BUY)
-            {
-                auto it = buy_levels_.find(price);
-                return (it != buy_levels_.end()) ? it->second->volume() : 0;
-            }
-            else
-            {
-                auto it = sell_levels_.find(price);
-                return (it != sell_levels_.end()) ? it->second->volume() : 0;
-            }
+            const PriceLevelImpl *level = find_level(price, side);
+            return level ? level->volume() : 0;
         }
 
         uint32_t order_count_at_price(int64_t price, Side side) const override
         {
-            if (side == Side::BUY)
-            {
-                auto it = buy_levels_.find(price);
-                return (it != buy_levels_.end()) ? it->second->order_count() : 0;
-            }
-            else
-            {
-                auto it = sell_levels_.find(price);
-                return (it != sell_levels_.end()) ? it->second->order_count() : 0;
-            }
+            const PriceLevelImpl *level = find_level(price, side);
+            return level ? static_cast<uint32_t>(level->order_count()) : 0;
         }
 
         uint64_t symbol_id() const override
@@ -415,23 +2160,56 @@ namespace micromatch::core
             return symbol_id_;
         }
 
+        OrderBookDepth depth(size_t n) const override
+        {
+            bids_.depth.refill_if_needed(bids_.levels);
+            asks_.depth.refill_if_needed(asks_.levels);
+
+            OrderBookDepth snapshot(symbol_id_);
+            snapshot.bid_count = bids_.depth.copy_to(snapshot.bids, n);
+            snapshot.ask_count = asks_.depth.copy_to(snapshot.asks, n);
+            return snapshot;
+        }
+
         size_t total_orders() const override
         {
             return order_map_.size();
         }
 
+        utils::PoolStats pool_stats() const override
+        {
+            return pool_.stats();
+        }
+
+        void set_clock(uint64_t now_ns) override
+        {
+            clock_ns_ = now_ns;
+        }
+
         void clear() override
         {
-            buy_levels_.clear();
-            sell_levels_.clear();
-            order_map_.clear();
+            release_all_orders();
+            last_trade_price_.reset();
+            in_auction_ = false;
         }
     };
 
     // Factory function implementation
     std::unique_ptr<IOrderBook> create_order_book(uint64_t symbol_id)
     {
-        return std::make_unique<OrderBookImpl>(symbol_id);
+        return create_order_book(symbol_id, OrderBookConfig{});
+    }
+
+    std::unique_ptr<IOrderBook> create_order_book(uint64_t symbol_id, const OrderBookConfig &config)
+    {
+        switch (config.level_storage)
+        {
+        case PriceLevelStorage::LADDER:
+            return std::make_unique<OrderBookImpl<LadderLevels>>(symbol_id, config);
+        case PriceLevelStorage::MAP:
+        default:
+            return std::make_unique<OrderBookImpl<MapLevels>>(symbol_id, config);
+        }
     }
 
 } // namespace micromatch::core
\ No newline at end of file
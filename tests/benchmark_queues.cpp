@@ -3,7 +3,10 @@
 #include <vector>
 #include <chrono>
 #include <random>
+#include <algorithm>
+#include <ctime>
 #include "utils/spsc_queue.hpp"
+#include "utils/spsc_ring.hpp"
 #include "utils/mpmc_queue.hpp"
 
 using namespace micromatch::utils;
@@ -97,6 +100,119 @@ static void BM_SPSC_PingPong(benchmark::State &state)
 }
 BENCHMARK(BM_SPSC_PingPong);
 
+// SPSC list queue against the fixed ring: a producer thread streams a
+// run of items through the queue while the benchmark thread drains it.
+// Both go through try_push/try_pop, so only the queue differs.
+template <typename Queue>
+static void BM_SPSC_Stream(benchmark::State &state)
+{
+    constexpr uint64_t ITEMS = 1 << 18;
+    for (auto _ : state)
+    {
+        Queue queue;
+        std::thread producer([&]()
+                             {
+            for (uint64_t i = 0; i < ITEMS; ++i) {
+                while (!queue.try_push(TestData(i))) {
+                    std::this_thread::yield();
+                }
+            } });
+
+        TestData data;
+        uint64_t received = 0;
+        while (received < ITEMS)
+        {
+            if (queue.try_pop(data))
+            {
+                benchmark::DoNotOptimize(data);
+                ++received;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ITEMS);
+}
+BENCHMARK_TEMPLATE(BM_SPSC_Stream, SPSCQueue<TestData>)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_Stream, SPSCRing<TestData, 4096>)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_SPSCRing_PushPop(benchmark::State &state)
+{
+    SPSCRing<TestData, 1024> ring;
+    TestData data;
+    uint64_t counter = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ring.try_push(TestData(counter++)));
+        benchmark::DoNotOptimize(ring.try_pop(data));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SPSCRing_PushPop);
+
+// One item per call against batches of state.range(0) through the batch
+// API: push a burst, then consume it in place
+template <typename Queue>
+static void BM_SPSCRing_BatchRoundTrip(benchmark::State &state)
+{
+    const auto batch = static_cast<size_t>(state.range(0));
+    Queue queue;
+    std::vector<TestData> items(batch);
+    uint64_t sum = 0;
+    auto visit = [&sum](TestData &data)
+    { sum += data.id; };
+
+    for (auto _ : state)
+    {
+        if (batch == 1)
+        {
+            queue.try_push(items[0]);
+            queue.consume(visit, 1);
+        }
+        else
+        {
+            queue.try_push_n(items);
+            queue.consume(visit, batch);
+        }
+    }
+
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK_TEMPLATE(BM_SPSCRing_BatchRoundTrip, SPSCRing<TestData, 1024>)->Arg(1)->Arg(16)->Arg(64);
+
+template <typename Queue>
+static void BM_MPMC_BatchRoundTrip(benchmark::State &state)
+{
+    const auto batch = static_cast<size_t>(state.range(0));
+    Queue queue;
+    std::vector<TestData> items(batch);
+    std::vector<TestData> out(batch);
+
+    for (auto _ : state)
+    {
+        if (batch == 1)
+        {
+            queue.try_enqueue(items[0]);
+            benchmark::DoNotOptimize(queue.try_dequeue());
+        }
+        else
+        {
+            queue.try_push_n(items);
+            benchmark::DoNotOptimize(queue.pop_n(out.data(), batch));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK_TEMPLATE(BM_MPMC_BatchRoundTrip, MPMCQueue<TestData, 1024>)->Arg(1)->Arg(16)->Arg(64);
+
 // MPMC Queue Benchmarks
 static void BM_MPMC_SingleProducer(benchmark::State &state)
 {
@@ -262,6 +378,28 @@ static void BM_SPSC_Latency(benchmark::State &state)
 }
 BENCHMARK(BM_SPSC_Latency)->UseManualTime();
 
+static void BM_SPSCRing_Latency(benchmark::State &state)
+{
+    SPSCRing<TestData, 1024> ring;
+    TestData result;
+
+    for (auto _ : state)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        TestData data(42);
+        ring.try_push(std::move(data));
+        ring.try_pop(result);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        state.SetIterationTime(elapsed.count() / 1e9);
+    }
+
+    state.SetLabel("Round-trip latency");
+}
+BENCHMARK(BM_SPSCRing_Latency)->UseManualTime();
+
 static void BM_MPMC_Latency(benchmark::State &state)
 {
     MPMCQueue<TestData, 1024> queue;
@@ -283,6 +421,81 @@ static void BM_MPMC_Latency(benchmark::State &state)
 }
 BENCHMARK(BM_MPMC_Latency)->UseManualTime();
 
+// Consumer CPU against delivery latency for a polling consumer and one
+// sleeping in pop_wait (arg 0: 0 = poll with dequeue(), 1 = pop_wait)
+// at a low rate (arg 1 = 0: one message per 200µs) and flat out
+// (arg 1 = 1). Counters: consumer CPU time as a share of wall time, and
+// p50 / p99 latency from push to pop.
+static double thread_cpu_seconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t steady_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static void BM_MPMC_WaitCpuVsLatency(benchmark::State &state)
+{
+    const bool blocking = state.range(0) != 0;
+    const bool flat_out = state.range(1) != 0;
+    const uint64_t messages = flat_out ? 200000 : 2000;
+
+    for (auto _ : state)
+    {
+        MPMCQueue<TestData, 1024> queue;
+        std::vector<double> samples;
+        samples.reserve(messages);
+        double consumer_cpu = 0;
+
+        const auto wall_start = std::chrono::steady_clock::now();
+        std::thread consumer([&]()
+                             {
+            const double cpu_start = thread_cpu_seconds();
+            for (uint64_t received = 0; received < messages;) {
+                auto data = blocking ? queue.pop_wait() : queue.dequeue();
+                if (data) {
+                    samples.push_back(static_cast<double>(steady_ns() - data->timestamp));
+                    ++received;
+                }
+            }
+            consumer_cpu = thread_cpu_seconds() - cpu_start; });
+
+        for (uint64_t i = 0; i < messages; ++i)
+        {
+            TestData data(i);
+            data.timestamp = steady_ns();
+            while (!queue.push_wait(data))
+            {
+            }
+            if (!flat_out)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+        consumer.join();
+        const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+        std::sort(samples.begin(), samples.end());
+        state.counters["consumer_cpu_pct"] = 100.0 * consumer_cpu / wall;
+        state.counters["p50_ns"] = samples[samples.size() / 2];
+        state.counters["p99_ns"] = samples[samples.size() * 99 / 100];
+    }
+
+    state.SetItemsProcessed(state.iterations() * messages);
+    state.SetLabel(std::string(blocking ? "pop_wait" : "poll") + (flat_out ? ", flat out" : ", low rate"));
+}
+BENCHMARK(BM_MPMC_WaitCpuVsLatency)
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
 // Contention benchmarks
 static void BM_MPMC_Contention(benchmark::State &state)
 {
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "core/orderbook.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace micromatch::core;
+
+// Global allocation counter. Replacing operator new affects the whole test
+// binary, which is why these tests live in their own executable.
+namespace
+{
+    std::atomic<size_t> g_allocations{0};
+}
+
+void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void *ptr = std::aligned_alloc(align, (size + align - 1) / align * align))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+class AllocationTest : public ::testing::Test
+{
+protected:
+    uint64_t next_order_id = 1;
+
+    Order create_order(Side side, int64_t price, uint32_t quantity)
+    {
+        return Order(next_order_id++, 1, price, quantity, side);
+    }
+};
+
+TEST_F(AllocationTest, MatchPathIsAllocationFree)
+{
+    OrderBookConfig config;
+    config.level_storage = PriceLevelStorage::LADDER;
+    config.ladder_levels = 1024;
+    config.reference_price = 10000;
+    config.initial_order_capacity = 8192;
+    auto book = create_order_book(1, config);
+
+    std::vector<Trade> trades;
+    trades.reserve(256);
+
+    // Seed resting liquidity on both sides
+    for (int i = 0; i < 100; ++i)
+    {
+        book->add_order(create_order(Side::SELL, 10001 + i % 10, 10), trades);
+        book->add_order(create_order(Side::BUY, 9999 - i % 10, 10), trades);
+    }
+    trades.clear();
+
+    const size_t before = g_allocations.load();
+
+    for (int round = 0; round < 1000; ++round)
+    {
+        // Aggressive buy sweeping two levels, then replenish the asks
+        trades.clear();
+        book->add_order(create_order(Side::BUY, 10002, 120), trades);
+        for (int i = 0; i < 12; ++i)
+        {
+            trades.clear();
+            book->add_order(create_order(Side::SELL, 10001 + i % 2, 10), trades);
+        }
+
+        // Partial fill of the best bid, then a rest-and-cancel
+        trades.clear();
+        book->add_order(create_order(Side::SELL, 9999, 5), trades);
+        auto passive = create_order(Side::BUY, 9990, 10);
+        book->add_order(passive, trades);
+        EXPECT_TRUE(book->cancel_order(passive.order_id));
+
+        // Market data poll after every round
+        auto depth = book->depth();
+        EXPECT_GT(depth.ask_count, 0u);
+    }
+
+    EXPECT_EQ(g_allocations.load() - before, 0u);
+    EXPECT_GT(book->total_orders(), 0u);
+
+    // The vector-returning overload allocates its result, which also shows
+    // the counter is live
+    const size_t legacy_before = g_allocations.load();
+    auto fills = book->add_order(create_order(Side::BUY, 10002, 10));
+    EXPECT_FALSE(fills.empty());
+    EXPECT_GT(g_allocations.load() - legacy_before, 0u);
+}
+
+TEST_F(AllocationTest, LadderFollowsDriftingTouchPastRestingFarOrder)
+{
+    OrderBookConfig config;
+    config.level_storage = PriceLevelStorage::LADDER;
+    config.ladder_levels = 64;
+    config.reference_price = 10000;
+    config.initial_order_capacity = 1024;
+    auto book = create_order_book(1, config);
+
+    std::vector<Trade> trades;
+    trades.reserve(16);
+
+    // A deep bid stays put at the bottom of the first window while the
+    // touch walks up far past the top of it
+    book->add_order(create_order(Side::BUY, 9970, 10), trades);
+    for (int64_t price = 10000; price <= 10500; ++price)
+    {
+        auto bid = create_order(Side::BUY, price, 10);
+        book->add_order(bid, trades);
+        EXPECT_TRUE(book->cancel_order(bid.order_id));
+    }
+
+    // Touch activity is back on the slots, not the overflow tree
+    const size_t before = g_allocations.load();
+    for (int round = 0; round < 100; ++round)
+    {
+        auto bid = create_order(Side::BUY, 10500 - round % 8, 10);
+        book->add_order(bid, trades);
+        trades.clear();
+        book->add_order(create_order(Side::SELL, 10500 - round % 8, 4), trades);
+        EXPECT_TRUE(book->cancel_order(bid.order_id));
+    }
+    EXPECT_EQ(g_allocations.load() - before, 0u);
+    EXPECT_EQ(book->best_bid(), 9970);
+}
@@ -4,7 +4,11 @@
 #include <chrono>
 #include <vector>
 #include <atomic>
+#include <cstdio>
+#include <csignal>
+#include <filesystem>
 #include <iostream>
+#include <sys/resource.h>
 
 using namespace micromatch::core;
 using namespace std::chrono_literals;
@@ -59,6 +63,20 @@ protected:
         return order;
     }
 
+    // Replace the running engine with one built from `config`
+    void restart_with(const MatchingEngineConfig &config)
+    {
+        engine->stop();
+        engine = create_matching_engine(config);
+        engine->set_trade_callback([this](const Trade &trade)
+                                   { captured_trades.push_back(trade); });
+        engine->set_order_callback([this](const Order &order, bool accepted)
+                                   { captured_orders.push_back({order, accepted}); });
+        engine->register_symbol(1);
+        engine->register_symbol(2);
+        engine->start();
+    }
+
     void wait_for_trades(size_t expected_count, std::chrono::milliseconds timeout = 100ms)
     {
         auto start = std::chrono::steady_clock::now();
@@ -223,6 +241,31 @@ TEST_F(MatchingEngineTest, ModifyOrder)
     EXPECT_EQ(book->volume_at_price(101, Side::BUY), 20);
 }
 
+TEST_F(MatchingEngineTest, ModifyInPlaceAndCrossing)
+{
+    auto bid = create_order(1, Side::BUY, 100, 10);
+    auto ask = create_order(1, Side::SELL, 102, 10);
+    engine->submit_order(bid);
+    engine->submit_order(ask);
+
+    wait_for_orders(2);
+
+    engine->modify_order(1, bid.order_id, 100, 5);  // Reduce in place
+    engine->modify_order(1, ask.order_id, 100, 10); // Reprice through the bid
+
+    std::this_thread::sleep_for(10ms);
+
+    auto stats = engine->get_stats();
+    EXPECT_EQ(stats.modified_orders, 2);
+    EXPECT_EQ(stats.modified_in_place, 1);
+    EXPECT_EQ(stats.total_trades, 1);
+    EXPECT_EQ(stats.total_volume, 5);
+
+    auto book = engine->get_order_book(1);
+    EXPECT_FALSE(book->best_bid().has_value());
+    EXPECT_EQ(book->volume_at_price(100, Side::SELL), 5);
+}
+
 // Multi-symbol tests
 TEST_F(MatchingEngineTest, MultipleSymbols)
 {
@@ -379,4 +422,686 @@ TEST_F(MatchingEngineTest, SubmitAfterStop)
     engine->stop();
 
     EXPECT_THROW({ engine->submit_order(create_order(1, Side::BUY, 100, 10)); }, std::runtime_error);
-}
\ No newline at end of file
+}
+TEST_F(MatchingEngineTest, BatchAuctionClearsAtUniformPrice)
+{
+    MatchingEngineConfig config;
+    config.mode = MatchingMode::BATCH_AUCTION;
+    config.batch_interval = std::chrono::milliseconds(5);
+    restart_with(config);
+
+    // Continuous matching would print symbol 1 at the resting buy's 101.
+    // The batch executes 10 with 5 left over at either limit, and the
+    // tie between them goes to the lower price.
+    engine->submit_order(create_order(1, Side::BUY, 101, 15));
+    engine->submit_order(create_order(1, Side::SELL, 99, 10));
+    engine->submit_order(create_order(2, Side::SELL, 200, 5));
+    engine->submit_order(create_order(2, Side::BUY, 200, 5));
+
+    wait_for_trades(2);
+    ASSERT_EQ(captured_trades.size(), 2);
+    for (const auto &trade : captured_trades)
+    {
+        EXPECT_EQ(trade.price, trade.symbol_id == 1 ? 99 : 200);
+    }
+
+    // The unfilled buy rests and the book keeps collecting
+    auto *book = engine->get_order_book(1);
+    EXPECT_EQ(book->volume_at_price(101, Side::BUY), 5);
+    EXPECT_TRUE(book->in_auction());
+
+    auto stats = engine->get_stats();
+    EXPECT_EQ(stats.total_orders, 4);
+    EXPECT_EQ(stats.total_volume, 15);
+}
+
+TEST_F(MatchingEngineTest, BatchAuctionHoldsTriggeredStopsForNextClear)
+{
+    const std::string path = ::testing::TempDir() + "fba_stops_journal.bin";
+    std::remove(path.c_str());
+
+    // One interval with a cross at 100 and a buy stop at 100, then a
+    // clear with no requests at all
+    auto stop = create_order(1, Side::BUY, 0, 5);
+    stop.type = OrderType::STOP;
+    stop.stop_price = 100;
+    {
+        auto journal = open_journal(JournalConfig{path, DurabilityPolicy::ASYNC});
+        ASSERT_NE(journal, nullptr);
+        uint64_t sequence = 0;
+        for (const Order &order : {create_order(1, Side::SELL, 100, 10), create_order(1, Side::BUY, 100, 4), stop})
+        {
+            JournalRecord record;
+            record.sequence = ++sequence;
+            record.symbol_id = order.symbol_id;
+            record.order = order;
+            journal->append(record);
+        }
+        for (int i = 0; i < 2; ++i)
+        {
+            JournalRecord record;
+            record.sequence = ++sequence;
+            record.entry = JournalEntry::BATCH_CLEAR;
+            record.timestamp_ns = sequence;
+            journal->append(record);
+        }
+    }
+
+    MatchingEngineConfig config;
+    config.mode = MatchingMode::BATCH_AUCTION;
+    config.journal = std::nullopt;
+
+    // The first clear prints 4 and triggers the stop, which fills in the
+    // second auction instead of matching straight away
+    auto replayed = create_matching_engine(config);
+    replayed->register_symbol(1);
+    std::vector<Trade> trades;
+    replayed->set_trade_callback([&](const Trade &trade)
+                                 { trades.push_back(trade); });
+    ReplayOptions in_order;
+    in_order.publish = true;
+    ASSERT_TRUE(replayed->replay_journal(path, in_order));
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].quantity, 4);
+    EXPECT_EQ(trades[0].timestamp_ns, 4);
+    EXPECT_EQ(trades[1].buy_order_id(), stop.order_id);
+    EXPECT_EQ(trades[1].quantity, 5);
+    EXPECT_EQ(trades[1].timestamp_ns, 5);
+
+    auto by_book = create_matching_engine(config);
+    by_book->register_symbol(1);
+    ASSERT_TRUE(by_book->replay_journal(path));
+    for (auto *other : {replayed.get(), by_book.get()})
+    {
+        EXPECT_EQ(other->get_stats().total_volume, 9);
+        EXPECT_EQ(other->get_order_book(1)->volume_at_price(100, Side::SELL), 1);
+        EXPECT_TRUE(other->get_order_book(1)->in_auction());
+    }
+    std::remove(path.c_str());
+}
+
+TEST_F(MatchingEngineTest, GtdOrderExpiresOnWorker)
+{
+    auto gtd = create_order(1, Side::BUY, 100, 10);
+    gtd.tif = TimeInForce::GTD;
+    gtd.expire_time_ns = std::chrono::steady_clock::now().time_since_epoch().count() + 5'000'000;
+    engine->submit_order(gtd);
+    engine->submit_order(create_order(1, Side::BUY, 99, 10));
+    wait_for_orders(2);
+
+    auto start = std::chrono::steady_clock::now();
+    while (engine->get_stats().expired_orders == 0 &&
+           std::chrono::steady_clock::now() - start < 200ms)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    EXPECT_EQ(engine->get_stats().expired_orders, 1);
+    EXPECT_EQ(engine->get_order_book(1)->total_orders(), 1);
+}
+
+TEST_F(MatchingEngineTest, MassCancelKillSwitch)
+{
+    for (uint64_t symbol : {1, 2})
+    {
+        auto order = create_order(symbol, Side::BUY, 100, 10);
+        order.client_id = 7;
+        engine->submit_order(order);
+        engine->submit_order(create_order(symbol, Side::SELL, 105, 10));
+    }
+    wait_for_orders(4);
+
+    engine->mass_cancel(IMatchingEngine::ALL_SYMBOLS, 7);
+    engine->mass_cancel(2, 0, Side::SELL);
+
+    auto start = std::chrono::steady_clock::now();
+    while (engine->get_stats().cancelled_orders < 3 &&
+           std::chrono::steady_clock::now() - start < 100ms)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    EXPECT_EQ(engine->get_stats().cancelled_orders, 3);
+    EXPECT_EQ(engine->get_order_book(1)->total_orders(), 1);
+    EXPECT_EQ(engine->get_order_book(2)->total_orders(), 0);
+}
+
+TEST_F(MatchingEngineTest, PurgeDayOrdersRunsOnWorkerAndReplays)
+{
+    const std::string path = ::testing::TempDir() + "purge_journal.bin";
+
+    for (const MatchingMode mode : {MatchingMode::CONTINUOUS, MatchingMode::BATCH_AUCTION})
+    {
+        std::remove(path.c_str());
+        MatchingEngineConfig config;
+        config.mode = mode;
+        config.journal = JournalConfig{path, DurabilityPolicy::ASYNC};
+        restart_with(config);
+        captured_orders.clear();
+
+        // A DAY and a GTC bid on each book, the purge, then a DAY bid after it
+        for (uint64_t symbol : {1, 2})
+        {
+            engine->submit_order(create_order(symbol, Side::BUY, 100, 10));
+            auto gtc = create_order(symbol, Side::BUY, 99, 10);
+            gtc.tif = TimeInForce::GTC;
+            engine->submit_order(gtc);
+        }
+        engine->purge_day_orders();
+        engine->submit_order(create_order(1, Side::BUY, 98, 10));
+        wait_for_orders(5);
+        engine->stop();
+
+        EXPECT_EQ(engine->get_order_book(1)->total_orders(), 2);
+        EXPECT_EQ(engine->get_order_book(2)->total_orders(), 1);
+        EXPECT_EQ(engine->get_order_book(1)->best_bid(), 99);
+
+        auto replayed = create_matching_engine(MatchingEngineConfig{mode, config.batch_interval, std::nullopt});
+        replayed->register_symbol(1);
+        replayed->register_symbol(2);
+        ASSERT_TRUE(replayed->replay_journal(path));
+        EXPECT_EQ(replayed->get_order_book(1)->total_orders(), 2);
+        EXPECT_EQ(replayed->get_order_book(2)->total_orders(), 1);
+        EXPECT_EQ(replayed->get_order_book(1)->best_bid(), 99);
+    }
+    std::remove(path.c_str());
+}
+
+TEST_F(MatchingEngineTest, CheckpointRestoresEveryBook)
+{
+    engine->submit_order(create_order(1, Side::BUY, 100, 10));
+    engine->submit_order(create_order(1, Side::BUY, 100, 20));
+    engine->submit_order(create_order(2, Side::SELL, 105, 30));
+    wait_for_orders(3);
+
+    const std::string path = ::testing::TempDir() + "engine_checkpoint.bin";
+    EXPECT_FALSE(engine->save_checkpoint(path)); // Only while stopped
+    engine->stop();
+    ASSERT_TRUE(engine->save_checkpoint(path));
+
+    auto restored = create_matching_engine();
+    ASSERT_TRUE(restored->restore_checkpoint(path));
+    ASSERT_NE(restored->get_order_book(1), nullptr);
+    ASSERT_NE(restored->get_order_book(2), nullptr);
+    EXPECT_EQ(restored->get_order_book(1)->volume_at_price(100, Side::BUY), 30);
+    EXPECT_EQ(restored->get_order_book(2)->best_ask(), 105);
+
+    // Time priority survives: the first order at 100 fills first
+    std::vector<Trade> trades;
+    restored->set_trade_callback([&](const Trade &trade)
+                                 { trades.push_back(trade); });
+    restored->start();
+    restored->submit_order(create_order(1, Side::SELL, 100, 10));
+    auto start = std::chrono::steady_clock::now();
+    while (restored->get_stats().total_trades < 1 &&
+           std::chrono::steady_clock::now() - start < 100ms)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    restored->stop();
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].passive_order_id, 1);
+
+    // A missing file leaves the books alone
+    EXPECT_FALSE(restored->restore_checkpoint(path + ".missing"));
+    EXPECT_NE(restored->get_order_book(1), nullptr);
+    std::remove(path.c_str());
+}
+
+TEST_F(MatchingEngineTest, JournalRecordsEveryRequestInOrder)
+{
+    const std::string path = ::testing::TempDir() + "engine_journal.bin";
+    std::remove(path.c_str());
+
+    MatchingEngineConfig config;
+    config.journal = JournalConfig{path, DurabilityPolicy::PER_BATCH};
+    restart_with(config);
+
+    auto first = create_order(1, Side::BUY, 100, 10);
+    engine->submit_order(first);
+    engine->submit_order(create_order(1, Side::SELL, 100, 4));
+    engine->modify_order(1, first.order_id, 100, 3);
+    engine->cancel_order(1, first.order_id);
+    engine->mass_cancel(IMatchingEngine::ALL_SYMBOLS, 7, Side::SELL);
+    engine->stop();
+
+    {
+        JournalReader reader(path);
+        ASSERT_TRUE(reader.valid());
+        ASSERT_EQ(reader.size(), 5);
+        const JournalEntry expected[] = {JournalEntry::NEW_ORDER, JournalEntry::NEW_ORDER,
+                                         JournalEntry::MODIFY_ORDER, JournalEntry::CANCEL_ORDER,
+                                         JournalEntry::MASS_CANCEL};
+        for (size_t i = 0; i < reader.size(); ++i)
+        {
+            EXPECT_EQ(reader[i].sequence, i + 1);
+            EXPECT_EQ(reader[i].entry, expected[i]);
+        }
+        EXPECT_EQ(reader[0].order.price, 100);
+        EXPECT_EQ(reader[2].new_quantity, 3);
+        EXPECT_EQ(reader[4].symbol_id, IMatchingEngine::ALL_SYMBOLS);
+        EXPECT_EQ(reader[4].client_id, 7);
+        EXPECT_TRUE(reader[4].has_side);
+    }
+
+    // Restarting appends to the same file and continues the sequence
+    engine->start();
+    engine->submit_order(create_order(2, Side::BUY, 50, 1));
+    engine->stop();
+    JournalReader reader(path);
+    ASSERT_EQ(reader.size(), 6);
+    EXPECT_EQ(reader[5].sequence, 6);
+    EXPECT_EQ(reader[5].symbol_id, 2);
+    std::remove(path.c_str());
+}
+
+TEST_F(MatchingEngineTest, EveryWaitStrategyPicksUpOrdersAfterIdle)
+{
+    using micromatch::utils::WaitStrategy;
+    for (const auto strategy : {WaitStrategy::SLEEP, WaitStrategy::BUSY_SPIN,
+                                WaitStrategy::SPIN_YIELD, WaitStrategy::SPIN_PARK})
+    {
+        MatchingEngineConfig config;
+        config.wait_strategy = strategy;
+        restart_with(config);
+        captured_orders.clear();
+
+        // Long enough for the worker to give up spinning and park
+        std::this_thread::sleep_for(20ms);
+        engine->submit_order(create_order(1, Side::BUY, 100, 10));
+        wait_for_orders(1, 1000ms);
+        EXPECT_EQ(captured_orders.size(), 1);
+
+        const auto start = std::chrono::steady_clock::now();
+        engine->stop();
+        EXPECT_LT(std::chrono::steady_clock::now() - start, 1000ms);
+    }
+}
+
+TEST_F(MatchingEngineTest, ConcurrentProducersKeepTheirOwnOrder)
+{
+    // A small ring so producers regularly find it full and back off
+    MatchingEngineConfig config;
+    config.ingress_capacity = 64;
+    restart_with(config);
+    captured_orders.clear();
+
+    constexpr uint64_t PRODUCERS = 4;
+    constexpr uint64_t PER_PRODUCER = 2000;
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([this, p]
+                               {
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i)
+            {
+                Order order;
+                order.order_id = (p + 1) * 1'000'000 + i;
+                order.client_id = p + 1;
+                order.symbol_id = 1 + p % 2;
+                order.side = Side::BUY; // Never crosses, so every order rests
+                order.price = 100;
+                order.quantity = 1;
+                engine->submit_order(order);
+            } });
+    }
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    wait_for_orders(PRODUCERS * PER_PRODUCER, 5000ms);
+    ASSERT_EQ(captured_orders.size(), PRODUCERS * PER_PRODUCER);
+
+    // Interleaving between producers is free, but each one's orders arrive
+    // in the order it submitted them
+    std::vector<uint64_t> next(PRODUCERS, 0);
+    for (const auto &[order, accepted] : captured_orders)
+    {
+        EXPECT_TRUE(accepted);
+        const uint64_t p = order.client_id - 1;
+        ASSERT_LT(p, PRODUCERS);
+        ASSERT_EQ(order.order_id, (p + 1) * 1'000'000 + next[p]);
+        ++next[p];
+    }
+    EXPECT_EQ(engine->get_stats().total_orders, PRODUCERS * PER_PRODUCER);
+}
+
+TEST_F(MatchingEngineTest, ExitedProducersGiveTheirRingsBack)
+{
+    captured_orders.clear();
+
+    // Far more threads over the engine's life than may submit at once,
+    // in waves so that at most eight are alive together
+    constexpr uint64_t WAVES = 40;
+    constexpr uint64_t PER_WAVE = 8;
+    for (uint64_t wave = 0; wave < WAVES; ++wave)
+    {
+        std::vector<std::thread> producers;
+        for (uint64_t p = 0; p < PER_WAVE; ++p)
+        {
+            producers.emplace_back([this, order = create_order(1, Side::BUY, 100, 1)]
+                                   { engine->submit_order(order); });
+        }
+        for (auto &producer : producers)
+        {
+            producer.join();
+        }
+    }
+
+    wait_for_orders(WAVES * PER_WAVE, 5000ms);
+    EXPECT_EQ(captured_orders.size(), WAVES * PER_WAVE);
+    EXPECT_EQ(engine->get_stats().total_orders, WAVES * PER_WAVE);
+}
+
+TEST_F(MatchingEngineTest, ManyConcurrentProducersAllGetARing)
+{
+    MatchingEngineConfig config;
+    config.ingress_capacity = 16;
+    restart_with(config);
+    captured_orders.clear();
+
+    // Every producer keeps its ring until all of them have submitted, so
+    // the slot table has to grow past its first chunk
+    constexpr uint64_t PRODUCERS = 200;
+    std::atomic<uint64_t> submitted{0};
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([&, order = create_order(1, Side::BUY, 100, 1)]
+                               {
+            engine->submit_order(order);
+            submitted.fetch_add(1);
+            while (submitted.load() < PRODUCERS) {
+                std::this_thread::yield();
+            } });
+    }
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+
+    wait_for_orders(PRODUCERS, 5000ms);
+    EXPECT_EQ(engine->get_stats().total_orders, PRODUCERS);
+}
+
+TEST_F(MatchingEngineTest, ShardedEngineRoutesBySymbolAndAggregates)
+{
+    MatchingEngineConfig config;
+    config.shards = 4;
+    auto sharded = create_matching_engine(config);
+    std::atomic<uint64_t> trades{0};
+    sharded->set_trade_callback([&](const Trade &)
+                                { trades.fetch_add(1); }); // Called from every shard's worker
+
+    constexpr uint64_t SYMBOLS = 8;
+    for (uint64_t symbol_id = 1; symbol_id <= SYMBOLS; ++symbol_id)
+    {
+        EXPECT_TRUE(sharded->register_symbol(symbol_id));
+    }
+    EXPECT_FALSE(sharded->register_symbol(3));
+    sharded->start();
+
+    for (uint64_t symbol_id = 1; symbol_id <= SYMBOLS; ++symbol_id)
+    {
+        sharded->submit_order(create_order(symbol_id, Side::BUY, 100, 10));
+        sharded->submit_order(create_order(symbol_id, Side::SELL, 100, 4));
+        sharded->submit_order(create_order(symbol_id, Side::SELL, 101, 5));
+    }
+    sharded->submit_order(create_order(99, Side::BUY, 100, 1)); // Unregistered
+    auto start = std::chrono::steady_clock::now();
+    while (sharded->get_stats().total_orders < 3 * SYMBOLS + 1 &&
+           std::chrono::steady_clock::now() - start < 1000ms)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    auto stats = sharded->get_stats();
+    EXPECT_EQ(stats.total_orders, 3 * SYMBOLS + 1);
+    EXPECT_EQ(stats.rejected_orders, 1);
+    EXPECT_EQ(stats.total_trades, SYMBOLS);
+    EXPECT_EQ(stats.total_volume, 4 * SYMBOLS);
+    EXPECT_EQ(trades.load(), SYMBOLS);
+
+    // Cancels and modifies reach the owning shard; mass cancel reaches all
+    sharded->cancel_order(2, 4);
+    sharded->modify_order(5, 13, 100, 3);
+    sharded->mass_cancel(IMatchingEngine::ALL_SYMBOLS, 0, Side::SELL);
+    sharded->stop();
+    EXPECT_EQ(sharded->get_order_book(2)->total_orders(), 0);
+    EXPECT_EQ(sharded->get_order_book(5)->volume_at_price(100, Side::BUY), 3);
+    EXPECT_FALSE(sharded->get_order_book(7)->best_ask().has_value());
+
+    // A checkpoint holds every shard's books and restores into any layout
+    const std::string path = ::testing::TempDir() + "sharded_checkpoint.bin";
+    ASSERT_TRUE(sharded->save_checkpoint(path));
+    auto single = create_matching_engine();
+    ASSERT_TRUE(single->restore_checkpoint(path));
+    config.shards = 3;
+    auto resharded = create_matching_engine(config);
+    ASSERT_TRUE(resharded->restore_checkpoint(path));
+    for (uint64_t symbol_id = 1; symbol_id <= SYMBOLS; ++symbol_id)
+    {
+        ASSERT_NE(single->get_order_book(symbol_id), nullptr);
+        ASSERT_NE(resharded->get_order_book(symbol_id), nullptr);
+        EXPECT_EQ(resharded->get_order_book(symbol_id)->total_orders(),
+                  sharded->get_order_book(symbol_id)->total_orders());
+    }
+    std::remove(path.c_str());
+}
+
+TEST_F(MatchingEngineTest, ReplayReproducesJournaledRunExactly)
+{
+    const std::string path = ::testing::TempDir() + "replay_journal.bin";
+
+    for (const MatchingMode mode : {MatchingMode::CONTINUOUS, MatchingMode::BATCH_AUCTION})
+    {
+        std::remove(path.c_str());
+        MatchingEngineConfig config;
+        config.mode = mode;
+        config.journal = JournalConfig{path, DurabilityPolicy::ASYNC};
+        restart_with(config);
+        captured_trades.clear();
+
+        // Crossing flow on two books plus an unregistered one, with
+        // modifies, cancels, a kill switch and GTD orders that expire
+        uint64_t seed = 7;
+        for (int i = 0; i < 3000; ++i)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            const uint64_t symbol_id = 1 + (seed >> 60) % 3;
+            const Side side = ((seed >> 40) & 1) ? Side::BUY : Side::SELL;
+            auto order = create_order(symbol_id, side, 95 + static_cast<int64_t>((seed >> 20) % 10),
+                                      1 + static_cast<uint32_t>((seed >> 8) % 50));
+            order.client_id = 1 + (seed >> 32) % 4;
+            if (i % 97 == 0)
+            {
+                order.tif = TimeInForce::GTD;
+                order.expire_time_ns = std::chrono::steady_clock::now().time_since_epoch().count() + 1'000'000;
+            }
+            engine->submit_order(order);
+            if (i % 5 == 0)
+            {
+                engine->modify_order(symbol_id, order.order_id - 3, order.price, 20);
+            }
+            if (i % 7 == 0)
+            {
+                engine->cancel_order(symbol_id, order.order_id - 11);
+            }
+            if (i % 1000 == 999)
+            {
+                engine->mass_cancel(IMatchingEngine::ALL_SYMBOLS, 2);
+                std::this_thread::sleep_for(3ms); // Let GTD orders expire
+            }
+        }
+        engine->stop();
+        const auto live = engine->get_stats();
+        ASSERT_GT(live.total_trades, 0);
+        ASSERT_GT(live.expired_orders, 0);
+
+        // In journal order with callbacks: the same trades, field for field
+        auto replayed = create_matching_engine(MatchingEngineConfig{mode, config.batch_interval, std::nullopt});
+        replayed->register_symbol(1);
+        replayed->register_symbol(2);
+        std::vector<Trade> trades;
+        replayed->set_trade_callback([&](const Trade &trade)
+                                     { trades.push_back(trade); });
+        ReplayOptions in_order;
+        in_order.publish = true;
+        ASSERT_TRUE(replayed->replay_journal(path, in_order));
+        ASSERT_EQ(trades.size(), captured_trades.size());
+        for (size_t i = 0; i < trades.size(); ++i)
+        {
+            const Trade &a = trades[i];
+            const Trade &b = captured_trades[i];
+            ASSERT_EQ(a.trade_id, b.trade_id);
+            ASSERT_EQ(a.aggressive_order_id, b.aggressive_order_id);
+            ASSERT_EQ(a.passive_order_id, b.passive_order_id);
+            ASSERT_EQ(a.symbol_id, b.symbol_id);
+            ASSERT_EQ(a.price, b.price);
+            ASSERT_EQ(a.quantity, b.quantity);
+            ASSERT_EQ(a.side, b.side);
+            ASSERT_EQ(a.is_maker_buy, b.is_maker_buy);
+            ASSERT_EQ(a.timestamp_ns, b.timestamp_ns);
+        }
+
+        // Book by book in parallel: the same books and counts
+        auto parallel = create_matching_engine(MatchingEngineConfig{mode, config.batch_interval, std::nullopt});
+        parallel->register_symbol(1);
+        parallel->register_symbol(2);
+        ReplayOptions by_book;
+        by_book.threads = 2;
+        ASSERT_TRUE(parallel->replay_journal(path, by_book));
+
+        for (auto *other : {replayed.get(), parallel.get()})
+        {
+            const auto stats = other->get_stats();
+            EXPECT_EQ(stats.total_orders, live.total_orders);
+            EXPECT_EQ(stats.rejected_orders, live.rejected_orders);
+            EXPECT_EQ(stats.total_trades, live.total_trades);
+            EXPECT_EQ(stats.total_volume, live.total_volume);
+            EXPECT_EQ(stats.cancelled_orders, live.cancelled_orders);
+            EXPECT_EQ(stats.modified_orders, live.modified_orders);
+            EXPECT_EQ(stats.expired_orders, live.expired_orders);
+            for (uint64_t symbol_id : {1, 2})
+            {
+                const auto expected = engine->get_order_book(symbol_id)->depth();
+                const auto actual = other->get_order_book(symbol_id)->depth();
+                EXPECT_EQ(other->get_order_book(symbol_id)->total_orders(),
+                          engine->get_order_book(symbol_id)->total_orders());
+                ASSERT_EQ(actual.bid_count, expected.bid_count);
+                ASSERT_EQ(actual.ask_count, expected.ask_count);
+                for (size_t i = 0; i < actual.bid_count; ++i)
+                {
+                    EXPECT_EQ(actual.bids[i].price, expected.bids[i].price);
+                    EXPECT_EQ(actual.bids[i].total_volume, expected.bids[i].total_volume);
+                }
+                for (size_t i = 0; i < actual.ask_count; ++i)
+                {
+                    EXPECT_EQ(actual.asks[i].price, expected.asks[i].price);
+                    EXPECT_EQ(actual.asks[i].total_volume, expected.asks[i].total_volume);
+                }
+            }
+        }
+
+        // Replaying from the last record on changes nothing
+        ReplayOptions tail;
+        tail.after_sequence = JournalReader(path)[JournalReader(path).size() - 1].sequence;
+        ASSERT_TRUE(parallel->replay_journal(path, tail));
+        EXPECT_EQ(parallel->get_stats().total_orders, live.total_orders);
+    }
+    EXPECT_FALSE(engine->replay_journal(path + ".missing"));
+    std::remove(path.c_str());
+}
+
+TEST_F(MatchingEngineTest, JournalKeepsOrderPastFullRingAndDropsTornTail)
+{
+    const std::string path = ::testing::TempDir() + "ring_journal.bin";
+    std::remove(path.c_str());
+
+    constexpr uint64_t RECORDS = 5000;
+    {
+        JournalConfig config{path, DurabilityPolicy::ASYNC};
+        config.ring_capacity = 4;
+        auto journal = open_journal(config);
+        ASSERT_NE(journal, nullptr);
+        for (uint64_t i = 1; i <= RECORDS; ++i)
+        {
+            JournalRecord record;
+            record.sequence = i;
+            record.order_id = i * 10;
+            journal->append(record);
+        }
+        journal->flush();
+        EXPECT_EQ(journal->durable_sequence(), RECORDS);
+        EXPECT_EQ(journal->stats().records, RECORDS);
+    }
+
+    // Simulate a crash part way through writing one more record
+    FILE *file = std::fopen(path.c_str(), "ab");
+    ASSERT_NE(file, nullptr);
+    std::fwrite("torn", 1, 4, file);
+    std::fclose(file);
+
+    auto reopened = open_journal(JournalConfig{path});
+    ASSERT_NE(reopened, nullptr);
+    EXPECT_EQ(reopened->last_sequence(), RECORDS);
+    reopened.reset();
+
+    JournalReader reader(path);
+    ASSERT_EQ(reader.size(), RECORDS);
+    for (uint64_t i = 0; i < RECORDS; ++i)
+    {
+        ASSERT_EQ(reader[i].sequence, i + 1);
+        ASSERT_EQ(reader[i].order_id, (i + 1) * 10);
+    }
+    std::remove(path.c_str());
+}
+
+TEST_F(MatchingEngineTest, JournalStopsAtFirstWriteErrorWithoutTornRecord)
+{
+    const std::string path = ::testing::TempDir() + "failing_journal.bin";
+    std::remove(path.c_str());
+
+    auto journal = open_journal(JournalConfig{path, DurabilityPolicy::PER_MESSAGE});
+    ASSERT_NE(journal, nullptr);
+
+    // Let the file grow by two and a half records, so the third record is
+    // written only in part and the write then fails
+    rlimit saved;
+    ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &saved), 0);
+    auto *old_handler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = saved;
+    limited.rlim_cur = sizeof(JournalFileHeader) + 2 * sizeof(JournalRecord) + sizeof(JournalRecord) / 2;
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &limited), 0);
+
+    for (uint64_t i = 1; i <= 5; ++i)
+    {
+        JournalRecord record;
+        record.sequence = i;
+        journal->append(record);
+    }
+    journal->flush();
+
+    ::setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, old_handler);
+
+    EXPECT_TRUE(journal->failed());
+    EXPECT_EQ(journal->durable_sequence(), 2);
+    EXPECT_EQ(journal->stats().records, 2);
+    EXPECT_EQ(journal->stats().write_errors, 1);
+    EXPECT_EQ(journal->stats().dropped, 3);
+
+    // Nothing written after the failure, even with room again
+    JournalRecord late;
+    late.sequence = 6;
+    journal->append(late);
+    journal->flush();
+    EXPECT_EQ(journal->durable_sequence(), 2);
+    journal.reset();
+
+    EXPECT_EQ(std::filesystem::file_size(path), sizeof(JournalFileHeader) + 2 * sizeof(JournalRecord));
+    JournalReader reader(path);
+    ASSERT_EQ(reader.size(), 2);
+    EXPECT_EQ(reader[1].sequence, 2);
+    std::remove(path.c_str());
+}
@@ -1,8 +1,15 @@
 #include <gtest/gtest.h>
 #include "core/orderbook.hpp"
+#include "utils/occupancy_bitmap.hpp"
+#include "utils/flat_id_map.hpp"
+#include "utils/timer_wheel.hpp"
 #include <vector>
 #include <algorithm>
 #include <random>
+#include <set>
+#include <sstream>
+#include <cstring>
+#include <unordered_map>
 
 using namespace micromatch::core;
 
@@ -213,6 +220,38 @@ TEST_F(OrderBookTest, CancelFromMiddleOfQueue)
     EXPECT_EQ(book->order_count_at_price(100, Side::BUY), 2);
 }
 
+TEST_F(OrderBookTest, CancelPreservesFifoOrder)
+{
+    std::vector<Order> sells;
+    for (int i = 0; i < 5; ++i)
+    {
+        sells.push_back(create_order(Side::SELL, 100, 10));
+        book->add_order(sells.back());
+    }
+
+    // Cancel head, tail and a middle order
+    EXPECT_TRUE(book->cancel_order(sells[0].order_id));
+    EXPECT_TRUE(book->cancel_order(sells[4].order_id));
+    EXPECT_TRUE(book->cancel_order(sells[2].order_id));
+    EXPECT_FALSE(book->cancel_order(sells[2].order_id)); // Already gone
+
+    EXPECT_EQ(book->order_count_at_price(100, Side::SELL), 2);
+    EXPECT_EQ(book->volume_at_price(100, Side::SELL), 20);
+
+    // Remaining orders still match in arrival order
+    auto trades = book->add_order(create_order(Side::BUY, 100, 20));
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].passive_order_id, sells[1].order_id);
+    EXPECT_EQ(trades[1].passive_order_id, sells[3].order_id);
+    EXPECT_FALSE(book->best_ask().has_value());
+
+    // Level can be rebuilt after being emptied by cancels
+    auto again = create_order(Side::SELL, 100, 5);
+    book->add_order(again);
+    EXPECT_TRUE(book->cancel_order(again.order_id));
+    EXPECT_EQ(book->total_orders(), 0);
+}
+
 // Modify order tests
 TEST_F(OrderBookTest, ModifyOrderPrice)
 {
@@ -242,7 +281,753 @@ TEST_F(OrderBookTest, ModifyNonExistentOrder)
     EXPECT_FALSE(modified.has_value());
 }
 
+TEST_F(OrderBookTest, ModifyQuantityDownKeepsPriority)
+{
+    auto first = create_order(Side::BUY, 100, 10);
+    auto second = create_order(Side::BUY, 100, 10);
+    book->add_order(first);
+    book->add_order(second);
+
+    std::vector<Trade> trades;
+    EXPECT_EQ(book->modify_order(first.order_id, 100, 4, trades), ModifyPath::IN_PLACE);
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(book->volume_at_price(100, Side::BUY), 14);
+
+    // The reduced order is still first in line
+    auto fills = book->add_order(create_order(Side::SELL, 100, 4));
+    ASSERT_EQ(fills.size(), 1);
+    EXPECT_EQ(fills[0].buy_order_id(), first.order_id);
+    EXPECT_EQ(book->total_orders(), 1);
+}
+
+TEST_F(OrderBookTest, ModifyQuantityUpLosesPriority)
+{
+    auto first = create_order(Side::BUY, 100, 10);
+    auto second = create_order(Side::BUY, 100, 10);
+    book->add_order(first);
+    book->add_order(second);
+
+    std::vector<Trade> trades;
+    EXPECT_EQ(book->modify_order(first.order_id, 100, 15, trades), ModifyPath::REQUEUED);
+    EXPECT_EQ(book->volume_at_price(100, Side::BUY), 25);
+
+    auto fills = book->add_order(create_order(Side::SELL, 100, 5));
+    ASSERT_EQ(fills.size(), 1);
+    EXPECT_EQ(fills[0].buy_order_id(), second.order_id);
+}
+
+TEST_F(OrderBookTest, ModifyPriceCrossingReturnsTrades)
+{
+    book->add_order(create_order(Side::SELL, 101, 6));
+    auto bid = create_order(Side::BUY, 99, 10);
+    book->add_order(bid);
+    const size_t pooled = book->pool_stats().in_use;
+
+    std::vector<Trade> trades;
+    EXPECT_EQ(book->modify_order(bid.order_id, 101, 10, trades), ModifyPath::REPRICED);
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].buy_order_id(), bid.order_id);
+    EXPECT_EQ(trades[0].quantity, 6);
+
+    // The remainder rests at the new price in the same pool slot
+    EXPECT_EQ(*book->best_bid(), 101);
+    EXPECT_EQ(book->volume_at_price(101, Side::BUY), 4);
+    EXPECT_FALSE(book->best_ask().has_value());
+    EXPECT_EQ(book->pool_stats().in_use, pooled - 1);
+}
+
+TEST_F(OrderBookTest, ModifyToZeroCancels)
+{
+    auto order = create_order(Side::SELL, 101, 10);
+    book->add_order(order);
+
+    std::vector<Trade> trades;
+    EXPECT_EQ(book->modify_order(order.order_id, 101, 0, trades), ModifyPath::CANCELLED);
+    EXPECT_EQ(book->total_orders(), 0);
+    EXPECT_FALSE(book->best_ask().has_value());
+    EXPECT_EQ(book->modify_order(order.order_id, 101, 5, trades), ModifyPath::NOT_FOUND);
+}
+
+// Order type and time-in-force tests
+TEST_F(OrderBookTest, MarketOrderSweepsAndNeverRests)
+{
+    book->add_order(create_order(Side::SELL, 101, 10));
+    book->add_order(create_order(Side::SELL, 105, 10));
+
+    auto order = create_order(Side::BUY, 0, 25);
+    order.type = OrderType::MARKET;
+    auto trades = book->add_order(order);
+
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].price, 101);
+    EXPECT_EQ(trades[1].price, 105);
+    EXPECT_FALSE(book->best_ask().has_value());
+    EXPECT_FALSE(book->best_bid().has_value());
+    EXPECT_EQ(book->total_orders(), 0);
+}
+
+TEST_F(OrderBookTest, IocRemainderIsDiscarded)
+{
+    book->add_order(create_order(Side::BUY, 100, 10));
+
+    auto order = create_order(Side::SELL, 100, 15);
+    order.tif = TimeInForce::IOC;
+    auto trades = book->add_order(order);
+
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].quantity, 10);
+    EXPECT_FALSE(book->best_ask().has_value());
+    EXPECT_EQ(book->total_orders(), 0);
+}
+
+TEST_F(OrderBookTest, FokRejectsWithoutTouchingBook)
+{
+    book->add_order(create_order(Side::SELL, 101, 10));
+    book->add_order(create_order(Side::SELL, 102, 10));
+    book->add_order(create_order(Side::SELL, 103, 10));
+
+    // 30 available in total, but only 20 within the limit
+    auto order = create_order(Side::BUY, 102, 21);
+    order.tif = TimeInForce::FOK;
+    EXPECT_TRUE(book->add_order(order).empty());
+    EXPECT_EQ(book->total_orders(), 3);
+    EXPECT_EQ(book->volume_at_price(101, Side::SELL), 10);
+    EXPECT_FALSE(book->best_bid().has_value());
+
+    order = create_order(Side::BUY, 102, 20);
+    order.tif = TimeInForce::FOK;
+    auto trades = book->add_order(order);
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(*book->best_ask(), 103);
+    EXPECT_EQ(book->total_orders(), 1);
+}
+
+TEST_F(OrderBookTest, MarketFokChecksWholeSide)
+{
+    book->add_order(create_order(Side::BUY, 100, 10));
+    book->add_order(create_order(Side::BUY, 50, 10));
+
+    auto order = create_order(Side::SELL, 0, 25);
+    order.type = OrderType::MARKET;
+    order.tif = TimeInForce::FOK;
+    EXPECT_TRUE(book->add_order(order).empty());
+    EXPECT_EQ(book->total_orders(), 2);
+
+    order = create_order(Side::SELL, 0, 20);
+    order.type = OrderType::MARKET;
+    order.tif = TimeInForce::FOK;
+    EXPECT_EQ(book->add_order(order).size(), 2);
+    EXPECT_EQ(book->total_orders(), 0);
+}
+
+// Stop order tests
+TEST_F(OrderBookTest, BuyStopTriggersOnTradeAtTrigger)
+{
+    book->add_order(create_order(Side::SELL, 100, 10));
+    book->add_order(create_order(Side::SELL, 102, 10));
+
+    auto stop = create_order(Side::BUY, 0, 5);
+    stop.type = OrderType::STOP;
+    stop.stop_price = 100;
+    EXPECT_TRUE(book->add_order(stop).empty());
+    EXPECT_EQ(book->total_orders(), 3);
+
+    // A trade at 100 releases the stop as a market order
+    auto trades = book->add_order(create_order(Side::BUY, 100, 4));
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[1].aggressive_order_id, stop.order_id);
+    EXPECT_EQ(trades[1].price, 100);
+    EXPECT_EQ(trades[1].quantity, 5);
+    EXPECT_EQ(book->volume_at_price(100, Side::SELL), 1);
+    EXPECT_FALSE(book->cancel_order(stop.order_id));
+}
+
+TEST_F(OrderBookTest, StopLimitRestsAtLimitOnceTriggered)
+{
+    book->add_order(create_order(Side::BUY, 100, 10));
+
+    auto stop = create_order(Side::SELL, 95, 20);
+    stop.type = OrderType::STOP_LIMIT;
+    stop.stop_price = 100;
+    book->add_order(stop);
+    EXPECT_FALSE(book->best_ask().has_value());
+
+    auto trades = book->add_order(create_order(Side::SELL, 100, 10));
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(*book->best_ask(), 95);
+    EXPECT_EQ(book->volume_at_price(95, Side::SELL), 20);
+}
+
+TEST_F(OrderBookTest, StopCascadeReleasesInPriceTimeOrder)
+{
+    book->add_order(create_order(Side::BUY, 100, 10));
+    book->add_order(create_order(Side::BUY, 98, 10));
+    book->add_order(create_order(Side::BUY, 96, 10));
+
+    auto make_stop = [&](int64_t trigger)
+    {
+        auto stop = create_order(Side::SELL, 0, 10);
+        stop.type = OrderType::STOP;
+        stop.stop_price = trigger;
+        book->add_order(stop);
+        return stop.order_id;
+    };
+    const auto deep = make_stop(98);   // Fired by the first stop's fill at 98
+    const auto first = make_stop(100); // Fired by the trade at 100
+    const auto second = make_stop(100);
+    make_stop(90); // Never reached
+
+    auto trades = book->add_order(create_order(Side::SELL, 100, 10));
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_EQ(trades[1].aggressive_order_id, first);
+    EXPECT_EQ(trades[1].price, 98);
+    EXPECT_EQ(trades[2].aggressive_order_id, second);
+    EXPECT_EQ(trades[2].price, 96);
+
+    // The 98 stop fired too, after both 100 stops, and found an empty bid side
+    EXPECT_FALSE(book->best_bid().has_value());
+    EXPECT_FALSE(book->cancel_order(deep));
+    EXPECT_EQ(book->total_orders(), 1);
+}
+
+TEST_F(OrderBookTest, StopFiresOnArrivalIfAlreadyThrough)
+{
+    book->add_order(create_order(Side::SELL, 100, 20));
+    book->add_order(create_order(Side::BUY, 100, 5));
+
+    auto stop = create_order(Side::BUY, 0, 5);
+    stop.type = OrderType::STOP;
+    stop.stop_price = 99;
+    auto trades = book->add_order(stop);
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].aggressive_order_id, stop.order_id);
+    EXPECT_EQ(book->volume_at_price(100, Side::SELL), 10);
+}
+
+TEST_F(OrderBookTest, CancelUntriggeredStop)
+{
+    auto stop = create_order(Side::SELL, 0, 10);
+    stop.type = OrderType::STOP;
+    stop.stop_price = 95;
+    book->add_order(stop);
+
+    std::vector<Trade> trades;
+    EXPECT_EQ(book->modify_order(stop.order_id, 96, 10, trades), ModifyPath::REJECTED);
+    EXPECT_TRUE(book->cancel_order(stop.order_id));
+    EXPECT_EQ(book->total_orders(), 0);
+
+    book->add_order(create_order(Side::BUY, 95, 10));
+    EXPECT_TRUE(book->add_order(create_order(Side::SELL, 95, 10)).size() == 1);
+    EXPECT_EQ(book->total_orders(), 0);
+}
+
+// Call auction tests
+TEST_F(OrderBookTest, AuctionCollectsWithoutMatching)
+{
+    book->begin_auction();
+    EXPECT_TRUE(book->in_auction());
+
+    EXPECT_TRUE(book->add_order(create_order(Side::BUY, 105, 10)).empty());
+    EXPECT_TRUE(book->add_order(create_order(Side::SELL, 95, 10)).empty());
+    auto ioc = create_order(Side::SELL, 95, 10);
+    ioc.tif = TimeInForce::IOC;
+    EXPECT_TRUE(book->add_order(ioc).empty());
+
+    // The book stands crossed until the uncross
+    EXPECT_EQ(book->best_bid(), 105);
+    EXPECT_EQ(book->best_ask(), 95);
+    EXPECT_EQ(book->total_orders(), 2);
+}
+
+TEST_F(OrderBookTest, UncrossMaximisesVolumeThenUsesReferencePrice)
+{
+    auto fill = [&](IOrderBook &b)
+    {
+        b.begin_auction();
+        for (int64_t price : {102, 101, 100})
+        {
+            b.add_order(create_order(Side::BUY, price, 10));
+        }
+        for (int64_t price : {99, 100, 101})
+        {
+            b.add_order(create_order(Side::SELL, price, 10));
+        }
+    };
+
+    // 20 lots execute at both 100 and 101 with an imbalance of 10 either way
+    fill(*book);
+    std::vector<Trade> trades;
+    auto result = book->uncross(trades, 101);
+    EXPECT_EQ(result.price, 101);
+    EXPECT_EQ(result.volume, 20);
+    EXPECT_EQ(result.imbalance, -10);
+    EXPECT_FALSE(book->in_auction());
+
+    uint64_t executed = 0;
+    for (const auto &trade : trades)
+    {
+        EXPECT_EQ(trade.price, 101);
+        executed += trade.quantity;
+    }
+    EXPECT_EQ(executed, 20);
+    EXPECT_EQ(book->best_bid(), 100);
+    EXPECT_EQ(book->best_ask(), 101);
+
+    auto other = create_order_book(1);
+    fill(*other);
+    trades.clear();
+    EXPECT_EQ(other->uncross(trades, 100).price, 100);
+
+    // Continuous matching resumes afterwards
+    EXPECT_EQ(book->add_order(create_order(Side::BUY, 101, 5)).size(), 1);
+}
+
+TEST_F(OrderBookTest, UncrossFillsMarketOrdersFirstAndCancelsRemainder)
+{
+    book->begin_auction();
+    auto market_buy = create_order(Side::BUY, 0, 15);
+    market_buy.type = OrderType::MARKET;
+    book->add_order(market_buy);
+    auto market_sell = create_order(Side::SELL, 0, 50);
+    market_sell.type = OrderType::MARKET;
+    book->add_order(market_sell);
+    book->add_order(create_order(Side::BUY, 98, 10));
+    book->add_order(create_order(Side::SELL, 100, 10));
+
+    std::vector<Trade> trades;
+    EXPECT_EQ(book->modify_order(market_buy.order_id, 101, 15, trades), ModifyPath::REJECTED);
+
+    // Demand 25 at 98 against 50 of market supply; the limit ask never trades
+    auto result = book->uncross(trades);
+    EXPECT_EQ(result.price, 98);
+    EXPECT_EQ(result.volume, 25);
+    EXPECT_EQ(result.imbalance, -25);
+    ASSERT_FALSE(trades.empty());
+    EXPECT_EQ(trades[0].buy_order_id(), market_buy.order_id);
+
+    // The rest of the market sell is cancelled, the limit ask still rests
+    EXPECT_EQ(book->total_orders(), 1);
+    EXPECT_FALSE(book->best_bid().has_value());
+    EXPECT_EQ(book->best_ask(), 100);
+}
+
+TEST_F(OrderBookTest, UncrossIntoNextAuctionHoldsTriggeredStops)
+{
+    book->begin_auction();
+    book->add_order(create_order(Side::SELL, 100, 10));
+    book->add_order(create_order(Side::BUY, 100, 4));
+    auto stop = create_order(Side::BUY, 0, 5);
+    stop.type = OrderType::STOP;
+    stop.stop_price = 100;
+    book->add_order(stop);
+
+    // The print at 100 triggers the stop, which waits for the next auction
+    std::vector<Trade> trades;
+    EXPECT_EQ(book->uncross(trades, 100, true).volume, 4);
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_TRUE(book->in_auction());
+    EXPECT_EQ(book->volume_at_price(100, Side::SELL), 6);
+
+    trades.clear();
+    EXPECT_EQ(book->uncross(trades, 100).volume, 5);
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].buy_order_id(), stop.order_id);
+    EXPECT_FALSE(book->in_auction());
+    EXPECT_EQ(book->volume_at_price(100, Side::SELL), 1);
+}
+
+TEST_F(OrderBookTest, UncrossWithoutCrossLeavesBookUntouched)
+{
+    book->begin_auction();
+    book->add_order(create_order(Side::BUY, 99, 10));
+    book->add_order(create_order(Side::SELL, 101, 10));
+
+    std::vector<Trade> trades;
+    auto result = book->uncross(trades, 100);
+    EXPECT_EQ(result.volume, 0);
+    EXPECT_TRUE(trades.empty());
+    EXPECT_FALSE(book->in_auction());
+    EXPECT_EQ(book->total_orders(), 2);
+}
+
+TEST_F(OrderBookTest, UncrossMatchesBruteForceAndLeavesBookUncrossed)
+{
+    std::mt19937 rng(41);
+    std::uniform_int_distribution<int64_t> price_dist(90, 110);
+    std::uniform_int_distribution<uint32_t> qty_dist(1, 40);
+
+    for (auto storage : {PriceLevelStorage::MAP, PriceLevelStorage::LADDER})
+    {
+        OrderBookConfig config;
+        config.level_storage = storage;
+        config.ladder_levels = 16;
+
+        for (int round = 0; round < 50; ++round)
+        {
+            auto b = create_order_book(1, config);
+            b->begin_auction();
+            std::vector<Order> orders;
+            for (int i = 0; i < 40; ++i)
+            {
+                orders.push_back(create_order(i % 2 ? Side::SELL : Side::BUY, price_dist(rng), qty_dist(rng)));
+                b->add_order(orders.back());
+            }
+
+            uint64_t best_volume = 0;
+            for (int64_t price = 90; price <= 110; ++price)
+            {
+                uint64_t demand = 0;
+                uint64_t supply = 0;
+                for (const auto &order : orders)
+                {
+                    if (order.side == Side::BUY && order.price >= price)
+                        demand += order.quantity;
+                    if (order.side == Side::SELL && order.price <= price)
+                        supply += order.quantity;
+                }
+                best_volume = std::max(best_volume, std::min(demand, supply));
+            }
+
+            std::vector<Trade> trades;
+            auto result = b->uncross(trades, 100);
+            EXPECT_EQ(result.volume, best_volume);
+
+            uint64_t executed = 0;
+            for (const auto &trade : trades)
+            {
+                EXPECT_EQ(trade.price, result.price);
+                executed += trade.quantity;
+            }
+            EXPECT_EQ(executed, best_volume);
+            if (b->best_bid() && b->best_ask())
+            {
+                EXPECT_LT(*b->best_bid(), *b->best_ask());
+            }
+        }
+    }
+}
+
+// Expiry and end-of-session tests
+TEST_F(OrderBookTest, GtdOrderExpiresAtDeadline)
+{
+    constexpr uint64_t MS = 1'000'000;
+    const uint64_t now = 1000 * MS;
+    book->expire_orders(now);
+
+    auto gtd = create_order(Side::BUY, 100, 10);
+    gtd.tif = TimeInForce::GTD;
+    gtd.expire_time_ns = now + 5 * MS;
+    book->add_order(gtd);
+    book->add_order(create_order(Side::BUY, 100, 10));
+
+    EXPECT_EQ(book->expire_orders(now + 4 * MS), 0);
+    EXPECT_EQ(book->expire_orders(now + 5 * MS), 1);
+    EXPECT_EQ(book->volume_at_price(100, Side::BUY), 10);
+    EXPECT_FALSE(book->cancel_order(gtd.order_id));
+
+    // GTD needs a deadline
+    auto undated = create_order(Side::BUY, 100, 10);
+    undated.tif = TimeInForce::GTD;
+    book->add_order(undated);
+    EXPECT_EQ(book->total_orders(), 1);
+}
+
+TEST_F(OrderBookTest, ExpirySkipsFilledAndCancelledGtdOrders)
+{
+    constexpr uint64_t MS = 1'000'000;
+    const uint64_t now = 1000 * MS;
+    book->expire_orders(now);
+
+    auto filled = create_order(Side::SELL, 100, 10);
+    filled.tif = TimeInForce::GTD;
+    filled.expire_time_ns = now + 5 * MS;
+    book->add_order(filled);
+    auto cancelled = create_order(Side::SELL, 101, 10);
+    cancelled.tif = TimeInForce::GTD;
+    cancelled.expire_time_ns = now + 5 * MS;
+    book->add_order(cancelled);
+
+    // The next order reuses the filled order's slot; the stale timer left
+    // there must not take the new order with it
+    EXPECT_EQ(book->add_order(create_order(Side::BUY, 100, 10)).size(), 1);
+    book->add_order(create_order(Side::SELL, 102, 10));
+    EXPECT_TRUE(book->cancel_order(cancelled.order_id));
+    EXPECT_EQ(book->expire_orders(now + 10 * MS), 0);
+    EXPECT_EQ(book->total_orders(), 1);
+}
+
+TEST_F(OrderBookTest, PurgeDayOrdersKeepsGtcAndGtd)
+{
+    // Only DAY orders: released wholesale
+    book->add_order(create_order(Side::BUY, 99, 10));
+    book->add_order(create_order(Side::SELL, 101, 10));
+    EXPECT_EQ(book->purge_day_orders(), 2);
+    EXPECT_EQ(book->total_orders(), 0);
+    EXPECT_EQ(book->pool_stats().in_use, 0);
+
+    // Mixed: DAY orders come off their own list, the rest stay in place
+    book->add_order(create_order(Side::BUY, 99, 10));
+    auto gtc = create_order(Side::BUY, 99, 20);
+    gtc.tif = TimeInForce::GTC;
+    book->add_order(gtc);
+    auto gtd = create_order(Side::SELL, 101, 30);
+    gtd.tif = TimeInForce::GTD;
+    gtd.expire_time_ns = UINT64_MAX / 2;
+    book->add_order(gtd);
+    auto stop = create_order(Side::SELL, 0, 10);
+    stop.type = OrderType::STOP;
+    stop.stop_price = 90;
+    book->add_order(stop);
+
+    EXPECT_EQ(book->purge_day_orders(), 2);
+    EXPECT_EQ(book->total_orders(), 2);
+    EXPECT_EQ(book->volume_at_price(99, Side::BUY), 20);
+    EXPECT_EQ(book->volume_at_price(101, Side::SELL), 30);
+    EXPECT_EQ(book->pool_stats().in_use, 2);
+
+    // The next session's DAY orders leave the list however they go:
+    // filled, cancelled, or by a client's mass cancel
+    std::vector<Trade> trades;
+    book->add_order(create_order(Side::SELL, 100, 5));
+    EXPECT_EQ(book->add_order(create_order(Side::BUY, 100, 5), trades), 1);
+    auto cancelled = create_order(Side::BUY, 97, 5);
+    book->add_order(cancelled);
+    EXPECT_TRUE(book->cancel_order(cancelled.order_id));
+    auto client_order = create_order(Side::SELL, 102, 5);
+    client_order.client_id = 7;
+    book->add_order(client_order);
+    EXPECT_EQ(book->mass_cancel(7, std::nullopt), 1);
+    auto kept = create_order(Side::SELL, 103, 5);
+    kept.client_id = 8;
+    book->add_order(kept);
+    book->add_order(create_order(Side::BUY, 96, 5));
+
+    EXPECT_EQ(book->purge_day_orders(), 2);
+    EXPECT_EQ(book->total_orders(), 2);
+    EXPECT_FALSE(book->cancel_order(kept.order_id));
+    EXPECT_EQ(book->mass_cancel(8, std::nullopt), 0);
+    EXPECT_EQ(book->purge_day_orders(), 0);
+
+    // Once the persistent orders are gone the wholesale path applies again
+    EXPECT_TRUE(book->cancel_order(gtc.order_id));
+    EXPECT_TRUE(book->cancel_order(gtd.order_id));
+    book->add_order(create_order(Side::BUY, 99, 10));
+    EXPECT_EQ(book->purge_day_orders(), 1);
+    EXPECT_EQ(book->pool_stats().in_use, 0);
+}
+
+// Mass cancel tests
+TEST_F(OrderBookTest, MassCancelByClient)
+{
+    auto for_client = [&](Side side, int64_t price, uint32_t quantity, uint64_t client)
+    {
+        auto order = create_order(side, price, quantity);
+        order.client_id = client;
+        return order;
+    };
+
+    book->add_order(for_client(Side::BUY, 99, 10, 7));
+    book->add_order(for_client(Side::BUY, 99, 10, 8));
+    book->add_order(for_client(Side::SELL, 101, 10, 7));
+    book->add_order(for_client(Side::SELL, 102, 10, 7));
+    auto stop = for_client(Side::SELL, 0, 10, 7);
+    stop.type = OrderType::STOP;
+    stop.stop_price = 90;
+    book->add_order(stop);
+
+    // A filled order leaves its client's list
+    EXPECT_EQ(book->add_order(for_client(Side::BUY, 101, 10, 8)).size(), 1);
+
+    EXPECT_EQ(book->mass_cancel(7, Side::BUY), 1);
+    EXPECT_EQ(book->volume_at_price(99, Side::BUY), 10);
+    EXPECT_EQ(book->mass_cancel(7), 2);
+    EXPECT_EQ(book->mass_cancel(7), 0);
+    EXPECT_EQ(book->mass_cancel(42), 0);
+    EXPECT_FALSE(book->best_ask().has_value());
+    EXPECT_EQ(book->total_orders(), 1);
+
+    // Slots freed above are reused without confusing the lists
+    book->add_order(for_client(Side::SELL, 105, 10, 8));
+    book->add_order(for_client(Side::SELL, 106, 10, 7));
+    EXPECT_EQ(book->mass_cancel(8), 2);
+    EXPECT_EQ(book->total_orders(), 1);
+    EXPECT_EQ(book->best_ask(), 106);
+}
+
+TEST_F(OrderBookTest, MassCancelSide)
+{
+    book->add_order(create_order(Side::BUY, 99, 10));
+    book->add_order(create_order(Side::BUY, 98, 10));
+    book->add_order(create_order(Side::SELL, 101, 10));
+    auto stop = create_order(Side::BUY, 0, 10);
+    stop.type = OrderType::STOP;
+    stop.stop_price = 110;
+    book->add_order(stop);
+
+    EXPECT_EQ(book->mass_cancel(0, Side::BUY), 3);
+    EXPECT_FALSE(book->best_bid().has_value());
+    EXPECT_EQ(book->depth().bid_count, 0);
+    EXPECT_EQ(book->best_ask(), 101);
+    EXPECT_EQ(book->pool_stats().in_use, 1);
+
+    // The side keeps working afterwards
+    book->add_order(create_order(Side::BUY, 100, 5));
+    EXPECT_EQ(book->best_bid(), 100);
+    EXPECT_EQ(book->mass_cancel(0), 2);
+    EXPECT_EQ(book->total_orders(), 0);
+}
+
 // Market data tests
+TEST_F(OrderBookTest, CheckpointRestoreMatchesOriginal)
+{
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int64_t> price_dist(90, 110);
+    std::uniform_int_distribution<uint32_t> qty_dist(1, 50);
+    std::uniform_int_distribution<int> kind_dist(0, 9);
+    auto random_order = [&]
+    {
+        auto order = create_order(kind_dist(rng) % 2 ? Side::BUY : Side::SELL,
+                                  price_dist(rng), qty_dist(rng));
+        order.client_id = kind_dist(rng) % 4;
+        switch (kind_dist(rng))
+        {
+        case 0:
+            order.tif = TimeInForce::GTD;
+            order.expire_time_ns = 1'000'000'000 + qty_dist(rng) * 1'000'000;
+            break;
+        case 1:
+            order.type = OrderType::STOP;
+            order.stop_price = (order.side == Side::BUY) ? 120 : 80;
+            break;
+        default:
+            break;
+        }
+        return order;
+    };
+    for (int i = 0; i < 2000; ++i)
+    {
+        book->add_order(random_order());
+    }
+
+    std::stringstream image;
+    book->write_checkpoint(image);
+    const std::string bytes = image.str();
+    const auto *data = reinterpret_cast<const std::byte *>(bytes.data());
+
+    // The image is independent of level storage
+    OrderBookConfig ladder_config;
+    ladder_config.level_storage = PriceLevelStorage::LADDER;
+    ladder_config.ladder_levels = 8;
+    for (const auto &config : {OrderBookConfig{}, ladder_config})
+    {
+        auto copy = create_order_book(1, config);
+        ASSERT_EQ(copy->restore_checkpoint(data, bytes.size()), bytes.size());
+        EXPECT_EQ(copy->total_orders(), book->total_orders());
+        const auto expected_depth = book->depth();
+        const auto actual_depth = copy->depth();
+        ASSERT_EQ(actual_depth.bid_count, expected_depth.bid_count);
+        for (uint32_t i = 0; i < expected_depth.bid_count; ++i)
+        {
+            EXPECT_EQ(actual_depth.bids[i].price, expected_depth.bids[i].price);
+            EXPECT_EQ(actual_depth.bids[i].total_volume, expected_depth.bids[i].total_volume);
+        }
+    }
+
+    // Queue priority, stops, client lists, timers and trade ids all carry over
+    auto copy = create_order_book(1);
+    ASSERT_EQ(copy->restore_checkpoint(data, bytes.size()), bytes.size());
+    for (int i = 0; i < 2000; ++i)
+    {
+        auto order = random_order();
+        order.quantity *= 4;
+        const auto expected = book->add_order(order);
+        const auto actual = copy->add_order(order);
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t t = 0; t < expected.size(); ++t)
+        {
+            EXPECT_EQ(actual[t].trade_id, expected[t].trade_id);
+            EXPECT_EQ(actual[t].passive_order_id, expected[t].passive_order_id);
+            EXPECT_EQ(actual[t].quantity, expected[t].quantity);
+        }
+    }
+    EXPECT_EQ(copy->mass_cancel(2), book->mass_cancel(2));
+    EXPECT_EQ(copy->expire_orders(1'030'000'000), book->expire_orders(1'030'000'000));
+    EXPECT_EQ(copy->total_orders(), book->total_orders());
+
+    // An index whose slots point at the wrong orders is refused. The
+    // index is the tail of the image: one 16-byte slot per capacity, with
+    // the capacity in the header's seventh field.
+    {
+        using IndexSlot = micromatch::utils::FlatIdMap<uint32_t>::Slot;
+        std::string corrupt = bytes;
+        uint64_t index_capacity;
+        std::memcpy(&index_capacity, corrupt.data() + 6 * sizeof(uint64_t), sizeof(index_capacity));
+        auto *slots = reinterpret_cast<IndexSlot *>(corrupt.data() + corrupt.size() - index_capacity * sizeof(IndexSlot));
+        IndexSlot *first = nullptr;
+        for (uint64_t i = 0; i < index_capacity; ++i)
+        {
+            if (slots[i].dist == 0)
+            {
+                continue;
+            }
+            if (!first)
+            {
+                first = &slots[i];
+                continue;
+            }
+            std::swap(first->value, slots[i].value);
+            break;
+        }
+        const auto *corrupt_data = reinterpret_cast<const std::byte *>(corrupt.data());
+        EXPECT_EQ(create_order_book(1)->restore_checkpoint(corrupt_data, corrupt.size()), 0);
+
+        first->value = 0xFFFFFF; // Outside the slab
+        EXPECT_EQ(create_order_book(1)->restore_checkpoint(corrupt_data, corrupt.size()), 0);
+    }
+
+    // A record listed under a queue it cannot rest in is refused: the
+    // records sit just ahead of the index, a resting limit then a stop
+    {
+        auto small = create_order_book(1);
+        small->add_order(create_order(Side::BUY, 99, 10));
+        auto stop = create_order(Side::BUY, 0, 10);
+        stop.type = OrderType::STOP;
+        stop.stop_price = 120;
+        small->add_order(stop);
+        std::stringstream small_image;
+        small->write_checkpoint(small_image);
+        const std::string small_bytes = small_image.str();
+
+        uint64_t index_capacity;
+        std::memcpy(&index_capacity, small_bytes.data() + 6 * sizeof(uint64_t), sizeof(index_capacity));
+        const size_t records = small_bytes.size() - index_capacity * 16 - 2 * sizeof(Order);
+        auto refused = [&](size_t record, auto &&corrupt)
+        {
+            std::string image = small_bytes;
+            Order order;
+            std::memcpy(&order, image.data() + records + record * sizeof(Order), sizeof(Order));
+            corrupt(order);
+            std::memcpy(image.data() + records + record * sizeof(Order), &order, sizeof(Order));
+            return create_order_book(1)->restore_checkpoint(
+                       reinterpret_cast<const std::byte *>(image.data()), image.size()) == 0;
+        };
+        EXPECT_FALSE(refused(0, [](Order &) {}));
+        EXPECT_TRUE(refused(0, [](Order &order)
+                            { order.type = OrderType::STOP; }));
+        EXPECT_TRUE(refused(0, [](Order &order)
+                            { order.side = Side::SELL; }));
+        EXPECT_TRUE(refused(1, [](Order &order)
+                            { order.type = OrderType::LIMIT; }));
+        EXPECT_TRUE(refused(1, [](Order &order)
+                            { order.stop_price = 121; }));
+    }
+
+    // A truncated image or one for another symbol is refused
+    EXPECT_EQ(copy->restore_checkpoint(data, bytes.size() - 1), 0);
+    EXPECT_EQ(copy->total_orders(), 0);
+    EXPECT_EQ(create_order_book(2)->restore_checkpoint(data, bytes.size()), 0);
+}
+
 TEST_F(OrderBookTest, MarketDataSnapshot)
 {
     book->add_order(create_order(Side::BUY, 99, 100));
@@ -338,6 +1123,51 @@ TEST_F(OrderBookTest, DuplicateOrderId)
     EXPECT_EQ(*book->best_bid(), 100); // Original order unchanged
 }
 
+TEST_F(OrderBookTest, PoolStatistics)
+{
+    OrderBookConfig config;
+    config.initial_order_capacity = 100;
+    auto pooled = create_order_book(1, config);
+
+    auto initial = pooled->pool_stats();
+    EXPECT_GE(initial.capacity, 100);
+    EXPECT_EQ(initial.in_use, 0);
+
+    std::vector<Order> orders;
+    for (int i = 0; i < 50; ++i)
+    {
+        orders.push_back(create_order(Side::BUY, 100 - (i % 5), 10));
+        pooled->add_order(orders.back());
+    }
+    EXPECT_EQ(pooled->pool_stats().in_use, 50);
+    EXPECT_EQ(pooled->pool_stats().high_water, 50);
+
+    // Cancels and fills return slots to the pool
+    for (int i = 0; i < 20; ++i)
+    {
+        EXPECT_TRUE(pooled->cancel_order(orders[i].order_id));
+    }
+    auto trades = pooled->add_order(create_order(Side::SELL, 100, 10));
+    EXPECT_EQ(trades.size(), 1);
+    EXPECT_EQ(pooled->pool_stats().in_use, 29);
+
+    // Slots are reused rather than growing the pool
+    for (int i = 0; i < 21; ++i)
+    {
+        pooled->add_order(create_order(Side::BUY, 90, 10));
+    }
+    auto stats = pooled->pool_stats();
+    EXPECT_EQ(stats.in_use, 50);
+    EXPECT_EQ(stats.high_water, 50);
+    EXPECT_EQ(stats.capacity, initial.capacity);
+
+    pooled->clear();
+    stats = pooled->pool_stats();
+    EXPECT_EQ(stats.in_use, 0);
+    EXPECT_EQ(stats.high_water, 50);
+    EXPECT_EQ(stats.capacity, initial.capacity);
+}
+
 TEST_F(OrderBookTest, ClearBook)
 {
     // Add some orders
@@ -352,3 +1182,524 @@ TEST_F(OrderBookTest, ClearBook)
     EXPECT_FALSE(book->best_bid().has_value());
     EXPECT_FALSE(book->best_ask().has_value());
 }
+
+// Dense price ladder tests
+class LadderOrderBookTest : public OrderBookTest
+{
+protected:
+    void SetUp() override
+    {
+        OrderBookConfig config;
+        config.level_storage = PriceLevelStorage::LADDER;
+        config.tick_size = 5;
+        config.ladder_levels = 16;
+        book = create_order_book(1, config);
+    }
+};
+
+TEST_F(LadderOrderBookTest, BasicMatching)
+{
+    book->add_order(create_order(Side::SELL, 1005, 10));
+    book->add_order(create_order(Side::SELL, 1010, 10));
+    book->add_order(create_order(Side::BUY, 995, 10));
+
+    EXPECT_EQ(*book->best_ask(), 1005);
+    EXPECT_EQ(*book->best_bid(), 995);
+
+    auto trades = book->add_order(create_order(Side::BUY, 1010, 15));
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].price, 1005);
+    EXPECT_EQ(trades[1].price, 1010);
+    EXPECT_EQ(*book->best_ask(), 1010);
+    EXPECT_EQ(book->volume_at_price(1010, Side::SELL), 5);
+}
+
+TEST_F(LadderOrderBookTest, OverflowAndOffGridPrices)
+{
+    // Window is centred on the first price: slots cover 960..1035
+    book->add_order(create_order(Side::BUY, 1000, 10));
+    book->add_order(create_order(Side::BUY, 2000, 10)); // Above window
+    book->add_order(create_order(Side::BUY, 500, 10));  // Below window
+    book->add_order(create_order(Side::BUY, 1003, 10)); // Off the tick grid
+
+    EXPECT_EQ(*book->best_bid(), 2000);
+    EXPECT_EQ(book->volume_at_price(1003, Side::BUY), 10);
+    EXPECT_EQ(book->order_count_at_price(500, Side::BUY), 1);
+
+    auto trades = book->add_order(create_order(Side::SELL, 500, 40));
+    ASSERT_EQ(trades.size(), 4);
+    EXPECT_EQ(trades[0].price, 2000);
+    EXPECT_EQ(trades[1].price, 1003);
+    EXPECT_EQ(trades[2].price, 1000);
+    EXPECT_EQ(trades[3].price, 500);
+    EXPECT_FALSE(book->best_bid().has_value());
+}
+
+TEST_F(LadderOrderBookTest, RecentresWhenWindowEmpties)
+{
+    auto first = create_order(Side::SELL, 1000, 10);
+    book->add_order(first);
+    auto far = create_order(Side::SELL, 5000, 10); // Overflow
+    book->add_order(far);
+
+    // Emptying the window lets the next order re-centre it, and the
+    // overflow level at 5000 is pulled into the new window
+    EXPECT_TRUE(book->cancel_order(first.order_id));
+    book->add_order(create_order(Side::SELL, 5010, 10));
+
+    EXPECT_EQ(*book->best_ask(), 5000);
+    EXPECT_EQ(book->volume_at_price(5000, Side::SELL), 10);
+    EXPECT_TRUE(book->cancel_order(far.order_id));
+    EXPECT_EQ(*book->best_ask(), 5010);
+}
+
+TEST_F(LadderOrderBookTest, WindowFollowsTouchPastRestingFarOrder)
+{
+    // Slots cover 960..1035; the deep bid at 965 never leaves
+    auto far = create_order(Side::BUY, 965, 10);
+    book->add_order(far);
+
+    // The touch walks up well past the window, leaving a level behind
+    // every 100 as it goes
+    for (int64_t price = 1000; price <= 1500; price += 5)
+    {
+        auto bid = create_order(Side::BUY, price, 10);
+        book->add_order(bid);
+        EXPECT_EQ(*book->best_bid(), price);
+        if (price % 100 != 0)
+        {
+            EXPECT_TRUE(book->cancel_order(bid.order_id));
+        }
+    }
+    EXPECT_EQ(book->total_orders(), 7);
+    EXPECT_EQ(book->volume_at_price(965, Side::BUY), 10);
+
+    // Levels parked outside the window still match best first, and each
+    // order can still be cancelled through its re-pointed level
+    auto trades = book->add_order(create_order(Side::SELL, 1200, 25));
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_EQ(trades[0].price, 1500);
+    EXPECT_EQ(trades[1].price, 1400);
+    EXPECT_EQ(trades[2].price, 1300);
+    EXPECT_EQ(book->volume_at_price(1300, Side::BUY), 5);
+    EXPECT_TRUE(book->cancel_order(far.order_id));
+    EXPECT_EQ(*book->best_bid(), 1300);
+    EXPECT_EQ(book->total_orders(), 4);
+
+    auto depth = book->depth();
+    ASSERT_EQ(depth.bid_count, 4);
+    EXPECT_EQ(depth.bids[3].price, 1000);
+}
+
+TEST_F(LadderOrderBookTest, FokFeasibilityIncludesOverflowLevels)
+{
+    book->add_order(create_order(Side::SELL, 1000, 10));
+    book->add_order(create_order(Side::SELL, 1003, 10)); // Off the tick grid
+    book->add_order(create_order(Side::SELL, 1010, 10));
+    book->add_order(create_order(Side::SELL, 2000, 10)); // Above window
+
+    auto order = create_order(Side::BUY, 1005, 21);
+    order.tif = TimeInForce::FOK;
+    EXPECT_TRUE(book->add_order(order).empty());
+    EXPECT_EQ(book->total_orders(), 4);
+
+    order = create_order(Side::BUY, 2000, 40);
+    order.tif = TimeInForce::FOK;
+    auto trades = book->add_order(order);
+    ASSERT_EQ(trades.size(), 4);
+    EXPECT_EQ(trades[1].price, 1003);
+    EXPECT_EQ(trades[3].price, 2000);
+    EXPECT_EQ(book->total_orders(), 0);
+}
+
+TEST_F(OrderBookTest, LadderMatchesMapBook)
+{
+    OrderBookConfig ladder_config;
+    ladder_config.level_storage = PriceLevelStorage::LADDER;
+    ladder_config.ladder_levels = 32;
+    auto ladder = create_order_book(1, ladder_config);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int64_t> price_dist(60, 140);
+    std::uniform_int_distribution<uint32_t> qty_dist(1, 50);
+    std::uniform_int_distribution<int> action_dist(0, 9);
+    std::vector<uint64_t> live_ids;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        if (action_dist(rng) < 3 && !live_ids.empty())
+        {
+            std::uniform_int_distribution<size_t> pick(0, live_ids.size() - 1);
+            size_t idx = pick(rng);
+            uint64_t id = live_ids[idx];
+            live_ids[idx] = live_ids.back();
+            live_ids.pop_back();
+            EXPECT_EQ(book->cancel_order(id), ladder->cancel_order(id));
+            continue;
+        }
+
+        Side side = (action_dist(rng) % 2 == 0) ? Side::BUY : Side::SELL;
+        auto order = create_order(side, price_dist(rng), qty_dist(rng));
+        auto expected = book->add_order(order);
+        auto actual = ladder->add_order(order);
+        live_ids.push_back(order.order_id);
+
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t t = 0; t < expected.size(); ++t)
+        {
+            EXPECT_EQ(expected[t].passive_order_id, actual[t].passive_order_id);
+            EXPECT_EQ(expected[t].price, actual[t].price);
+            EXPECT_EQ(expected[t].quantity, actual[t].quantity);
+        }
+        ASSERT_EQ(book->best_bid(), ladder->best_bid());
+        ASSERT_EQ(book->best_ask(), ladder->best_ask());
+    }
+
+    EXPECT_EQ(book->total_orders(), ladder->total_orders());
+    for (int64_t price = 60; price <= 140; ++price)
+    {
+        EXPECT_EQ(book->volume_at_price(price, Side::BUY), ladder->volume_at_price(price, Side::BUY));
+        EXPECT_EQ(book->volume_at_price(price, Side::SELL), ladder->volume_at_price(price, Side::SELL));
+    }
+}
+
+// Depth snapshot tests
+TEST_F(OrderBookTest, DepthReportsTopLevels)
+{
+    book->add_order(create_order(Side::BUY, 99, 10));
+    book->add_order(create_order(Side::BUY, 99, 5));
+    book->add_order(create_order(Side::BUY, 97, 20));
+    book->add_order(create_order(Side::SELL, 101, 7));
+
+    auto depth = book->depth();
+    EXPECT_EQ(depth.symbol_id, 1);
+    ASSERT_EQ(depth.bid_count, 2);
+    ASSERT_EQ(depth.ask_count, 1);
+    EXPECT_EQ(depth.bids[0].price, 99);
+    EXPECT_EQ(depth.bids[0].total_volume, 15);
+    EXPECT_EQ(depth.bids[0].order_count, 2);
+    EXPECT_EQ(depth.bids[1].price, 97);
+    EXPECT_EQ(depth.asks[0].price, 101);
+
+    EXPECT_EQ(book->depth(1).bid_count, 1);
+}
+
+TEST_F(OrderBookTest, DepthRefillsAfterSweep)
+{
+    for (int64_t i = 0; i < 25; ++i)
+    {
+        book->add_order(create_order(Side::SELL, 100 + i, 10));
+    }
+
+    // Take out the first twelve levels, exposing levels never cached
+    book->add_order(create_order(Side::BUY, 111, 120));
+
+    auto depth = book->depth();
+    ASSERT_EQ(depth.ask_count, OrderBookDepth::MAX_DEPTH);
+    for (size_t i = 0; i < depth.ask_count; ++i)
+    {
+        EXPECT_EQ(depth.asks[i].price, 112 + static_cast<int64_t>(i));
+        EXPECT_EQ(depth.asks[i].total_volume, 10);
+    }
+    EXPECT_EQ(depth.bid_count, 0);
+}
+
+TEST_F(OrderBookTest, DepthMatchesLevelScan)
+{
+    OrderBookConfig ladder_config;
+    ladder_config.level_storage = PriceLevelStorage::LADDER;
+    ladder_config.ladder_levels = 32;
+    auto ladder = create_order_book(1, ladder_config);
+
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<int64_t> price_dist(80, 120);
+    std::uniform_int_distribution<uint32_t> qty_dist(1, 50);
+    std::uniform_int_distribution<int> action_dist(0, 9);
+    std::vector<uint64_t> live_ids;
+
+    auto check = [](const IOrderBook &b)
+    {
+        auto depth = b.depth();
+        size_t bids = 0;
+        size_t asks = 0;
+        for (int64_t price = 120; price >= 80; --price)
+        {
+            if (b.order_count_at_price(price, Side::BUY) > 0 && bids < OrderBookDepth::MAX_DEPTH)
+            {
+                ASSERT_LT(bids, depth.bid_count);
+                EXPECT_EQ(depth.bids[bids].price, price);
+                EXPECT_EQ(depth.bids[bids].total_volume, b.volume_at_price(price, Side::BUY));
+                ++bids;
+            }
+        }
+        for (int64_t price = 80; price <= 120; ++price)
+        {
+            if (b.order_count_at_price(price, Side::SELL) > 0 && asks < OrderBookDepth::MAX_DEPTH)
+            {
+                ASSERT_LT(asks, depth.ask_count);
+                EXPECT_EQ(depth.asks[asks].price, price);
+                EXPECT_EQ(depth.asks[asks].order_count, b.order_count_at_price(price, Side::SELL));
+                ++asks;
+            }
+        }
+        EXPECT_EQ(depth.bid_count, bids);
+        EXPECT_EQ(depth.ask_count, asks);
+    };
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        const int action = action_dist(rng);
+        if (action < 3 && !live_ids.empty())
+        {
+            std::uniform_int_distribution<size_t> pick(0, live_ids.size() - 1);
+            const uint64_t id = live_ids[pick(rng)];
+            if (action == 0)
+            {
+                book->cancel_order(id);
+                ladder->cancel_order(id);
+            }
+            else
+            {
+                const int64_t price = price_dist(rng);
+                const uint32_t qty = qty_dist(rng);
+                std::vector<Trade> trades;
+                book->modify_order(id, price, qty, trades);
+                ladder->modify_order(id, price, qty, trades);
+            }
+        }
+        else
+        {
+            Side side = (action % 2 == 0) ? Side::BUY : Side::SELL;
+            auto order = create_order(side, price_dist(rng), qty_dist(rng));
+            book->add_order(order);
+            ladder->add_order(order);
+            live_ids.push_back(order.order_id);
+        }
+
+        if (i % 7 == 0)
+        {
+            check(*book);
+            check(*ladder);
+        }
+    }
+}
+
+// Occupancy bitmap used by the ladder for next-best-level search
+TEST(OccupancyBitmapTest, NextAndPrevMatchOrderedSet)
+{
+    const size_t size = 70000; // Spans several top-level bits
+    micromatch::utils::OccupancyBitmap bitmap(size);
+    std::set<size_t> reference;
+
+    EXPECT_EQ(bitmap.first(), micromatch::utils::OccupancyBitmap::NPOS);
+    EXPECT_EQ(bitmap.last(), micromatch::utils::OccupancyBitmap::NPOS);
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<size_t> index_dist(0, size - 1);
+    for (int i = 0; i < 200; ++i)
+    {
+        size_t index = index_dist(rng);
+        bitmap.set(index);
+        reference.insert(index);
+    }
+    bitmap.set(0);
+    bitmap.set(size - 1);
+    reference.insert(0);
+    reference.insert(size - 1);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        size_t index = *std::next(reference.begin(), index_dist(rng) % reference.size());
+        bitmap.clear(index);
+        reference.erase(index);
+    }
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        size_t from = index_dist(rng);
+        auto next = reference.lower_bound(from);
+        EXPECT_EQ(bitmap.find_next(from),
+                  next == reference.end() ? micromatch::utils::OccupancyBitmap::NPOS : *next);
+
+        auto prev = reference.upper_bound(from);
+        EXPECT_EQ(bitmap.find_prev(from),
+                  prev == reference.begin() ? micromatch::utils::OccupancyBitmap::NPOS : *std::prev(prev));
+    }
+
+    EXPECT_EQ(bitmap.first(), *reference.begin());
+    EXPECT_EQ(bitmap.last(), *reference.rbegin());
+
+    bitmap.reset();
+    EXPECT_FALSE(bitmap.any());
+}
+
+// Open-addressing order id index
+TEST(FlatIdMapTest, MatchesUnorderedMap)
+{
+    micromatch::utils::FlatIdMap<uint32_t> index(64);
+    std::unordered_map<uint64_t, uint32_t> reference;
+
+    std::mt19937_64 rng(3);
+    std::uniform_int_distribution<uint64_t> key_dist(1, 5000);
+    std::uniform_int_distribution<int> action_dist(0, 2);
+
+    for (uint32_t i = 0; i < 50000; ++i)
+    {
+        uint64_t key = key_dist(rng);
+        switch (action_dist(rng))
+        {
+        case 0:
+            EXPECT_EQ(index.insert(key, i), reference.emplace(key, i).second);
+            break;
+        case 1:
+            EXPECT_EQ(index.erase(key), reference.erase(key) == 1);
+            break;
+        default:
+        {
+            auto it = reference.find(key);
+            auto extracted = index.extract(key);
+            ASSERT_EQ(extracted.has_value(), it != reference.end());
+            if (extracted)
+            {
+                EXPECT_EQ(*extracted, it->second);
+                reference.erase(it);
+            }
+            break;
+        }
+        }
+        ASSERT_EQ(index.size(), reference.size());
+    }
+
+    // Table grew past its reservation and every surviving entry is reachable
+    EXPECT_GT(index.capacity(), 64);
+    for (const auto &[key, value] : reference)
+    {
+        const uint32_t *found = index.find(key);
+        ASSERT_NE(found, nullptr);
+        EXPECT_EQ(*found, value);
+    }
+
+    size_t visited = 0;
+    index.for_each([&](uint64_t key, uint32_t value)
+                   {
+        ++visited;
+        EXPECT_EQ(reference.at(key), value); });
+    EXPECT_EQ(visited, reference.size());
+
+    // Bulk sweep removes exactly the matching entries
+    const auto odd = [](uint64_t key, uint32_t)
+    { return key % 2 == 1; };
+    const size_t odd_count = std::count_if(reference.begin(), reference.end(),
+                                           [&](const auto &entry)
+                                           { return odd(entry.first, entry.second); });
+    EXPECT_EQ(index.erase_if(odd), odd_count);
+    ASSERT_EQ(index.size(), reference.size() - odd_count);
+    for (const auto &[key, value] : reference)
+    {
+        const uint32_t *found = index.find(key);
+        if (key % 2 == 1)
+        {
+            EXPECT_EQ(found, nullptr);
+        }
+        else
+        {
+            ASSERT_NE(found, nullptr);
+            EXPECT_EQ(*found, value);
+        }
+    }
+
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_FALSE(index.contains(reference.begin()->first));
+}
+
+TEST(FlatIdMapTest, LoadTableRejectsMalformedImages)
+{
+    using Map = micromatch::utils::FlatIdMap<uint32_t>;
+    Map source(100);
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(source.insert(1000 + i * 7, i));
+    }
+    const size_t capacity = source.capacity();
+    std::vector<Map::Slot> image(source.table(), source.table() + capacity);
+
+    Map copy;
+    ASSERT_TRUE(copy.load_table(image.data(), capacity, 100));
+    ASSERT_NE(copy.find(1000 + 7 * 42), nullptr);
+    EXPECT_EQ(*copy.find(1000 + 7 * 42), 42);
+
+    // Occupied slot count disagrees with the stated size
+    EXPECT_FALSE(copy.load_table(image.data(), capacity, 99));
+    EXPECT_TRUE(copy.empty());
+
+    // An entry that is not where its distance says it should be
+    auto moved = image;
+    for (auto &slot : moved)
+    {
+        if (slot.dist != 0)
+        {
+            ++slot.dist;
+            break;
+        }
+    }
+    EXPECT_FALSE(copy.load_table(moved.data(), capacity, 100));
+
+    // Every slot full with long distances would never end a probe
+    auto full = image;
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        full[i] = Map::Slot{i, 0, 1000};
+    }
+    EXPECT_FALSE(copy.load_table(full.data(), capacity, 100));
+    EXPECT_FALSE(copy.contains(12345));
+}
+
+TEST(TimerWheelTest, FiresEachTimerWithinOneTickOfItsDeadline)
+{
+    constexpr uint64_t TICK = 10;
+    micromatch::utils::TimerWheel wheel(TICK);
+    wheel.reserve(4096);
+    std::unordered_map<uint32_t, uint64_t> armed;
+
+    std::mt19937_64 rng(5);
+    std::uniform_int_distribution<uint32_t> handle_dist(0, 4095);
+    std::uniform_int_distribution<int> action_dist(0, 9);
+    // Spans every wheel level, and past the horizon of 64^4 ticks
+    std::uniform_int_distribution<int> shift_dist(0, 30);
+
+    uint64_t now = 1'000'000;
+    for (int i = 0; i < 20000; ++i)
+    {
+        const uint32_t handle = handle_dist(rng);
+        const int action = action_dist(rng);
+        if (action < 5)
+        {
+            const uint64_t deadline = now + (rng() & ((uint64_t{1} << shift_dist(rng)) - 1));
+            wheel.schedule(handle, deadline, deadline);
+            armed[handle] = deadline;
+        }
+        else if (action < 7)
+        {
+            EXPECT_EQ(wheel.cancel(handle), armed.erase(handle) == 1);
+        }
+        else
+        {
+            now += rng() & ((uint64_t{1} << shift_dist(rng)) - 1);
+            wheel.advance(now, [&](uint32_t fired, uint64_t deadline)
+                          {
+                auto it = armed.find(fired);
+                ASSERT_NE(it, armed.end());
+                EXPECT_EQ(it->second, deadline);
+                EXPECT_LE(deadline, now);
+                armed.erase(it); });
+
+            // Anything due a full tick ago must have fired
+            for (const auto &[handle_left, deadline] : armed)
+            {
+                EXPECT_GT(deadline + TICK, now);
+            }
+        }
+        ASSERT_EQ(wheel.size(), armed.size());
+    }
+}
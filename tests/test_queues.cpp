@@ -7,8 +7,12 @@
 #include <mutex>
 #include <iostream>
 #include <memory>
+#include <algorithm>
+#include <span>
 #include "utils/spsc_queue.hpp"
+#include "utils/spsc_ring.hpp"
 #include "utils/mpmc_queue.hpp"
+#include "utils/wait_strategy.hpp"
 
 using namespace micromatch::utils;
 
@@ -169,6 +173,194 @@ TEST_F(SPSCQueueTest, StressTest)
     consumer.join();
 }
 
+TEST_F(SPSCQueueTest, BatchOperations)
+{
+    EXPECT_TRUE(complex_queue.emplace(7, "seven"));
+    auto first = complex_queue.dequeue();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->id, 7);
+    EXPECT_EQ(first->name, "seven");
+
+    const std::vector<int> items{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(int_queue.try_push_n(items), items.size());
+
+    int out[4] = {};
+    ASSERT_EQ(int_queue.pop_n(out, 4), 4);
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[3], 3);
+
+    std::vector<int> seen;
+    EXPECT_EQ(int_queue.consume([&](int &value)
+                                { seen.push_back(value); },
+                                3),
+              3);
+    EXPECT_EQ(int_queue.consume([&](int &value)
+                                { seen.push_back(value); }),
+              3);
+    EXPECT_EQ(seen, (std::vector<int>{4, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(int_queue.consume([](int &) {}), 0);
+    EXPECT_TRUE(int_queue.empty());
+}
+
+// SPSC ring tests
+TEST(SPSCRingTest, FixedCapacityFillsAndWraps)
+{
+    SPSCRing<int, 8> ring;
+    EXPECT_EQ(ring.capacity(), 8);
+    EXPECT_TRUE(ring.empty());
+
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(8));
+    EXPECT_EQ(ring.size_approx(), 8);
+
+    // Free three slots and refill them across the end of the array
+    int value = -1;
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(ring.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    for (int i = 8; i < 11; ++i)
+    {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(11));
+
+    for (int i = 3; i < 11; ++i)
+    {
+        ASSERT_TRUE(ring.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.try_pop(value));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SPSCRingTest, RuntimeCapacityRoundsUpToPowerOfTwo)
+{
+    SPSCRing<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8);
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(8));
+}
+
+TEST(SPSCRingTest, FailedPushKeepsTheValue)
+{
+    SPSCRing<std::unique_ptr<int>, 2> ring;
+    EXPECT_TRUE(ring.try_push(std::make_unique<int>(1)));
+    EXPECT_TRUE(ring.try_push(std::make_unique<int>(2)));
+
+    auto extra = std::make_unique<int>(3);
+    EXPECT_FALSE(ring.try_push(std::move(extra)));
+    ASSERT_NE(extra, nullptr);
+    EXPECT_EQ(*extra, 3);
+}
+
+TEST(SPSCRingTest, BatchOperationsStopAtTheEdges)
+{
+    SPSCRing<int, 8> ring;
+    const std::vector<int> items{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    // Only what fits is pushed
+    EXPECT_EQ(ring.try_push_n(items), 8);
+    EXPECT_EQ(ring.try_push_n(items), 0);
+
+    int out[8] = {};
+    ASSERT_EQ(ring.pop_n(out, 5), 5);
+    EXPECT_EQ(out[4], 4);
+
+    // Refill across the end of the array
+    EXPECT_EQ(ring.try_push_n(std::span<const int>(items).subspan(8)), 2);
+    EXPECT_TRUE(ring.emplace(10));
+    EXPECT_TRUE(ring.emplace(11));
+    EXPECT_TRUE(ring.emplace(12));
+    EXPECT_FALSE(ring.emplace(13));
+
+    std::vector<int> seen;
+    EXPECT_EQ(ring.consume([&](int &value)
+                           { seen.push_back(value); }),
+              8);
+    EXPECT_EQ(seen, (std::vector<int>{5, 6, 7, 8, 9, 10, 11, 12}));
+    EXPECT_EQ(ring.pop_n(out, 8), 0);
+}
+
+TEST(SPSCRingTest, ConcurrentBatches)
+{
+    const int num_items = 100000;
+    SPSCRing<int, 64> ring;
+
+    std::thread producer([&]()
+                         {
+        std::vector<int> batch(24);
+        int next = 0;
+        while (next < num_items) {
+            const int count = std::min<int>(batch.size(), num_items - next);
+            for (int i = 0; i < count; ++i) {
+                batch[i] = next + i;
+            }
+            size_t pushed = 0;
+            while (pushed < static_cast<size_t>(count)) {
+                pushed += ring.try_push_n(std::span<const int>(batch).subspan(pushed, count - pushed));
+                std::this_thread::yield();
+            }
+            next += count;
+        } });
+
+    int expected = 0;
+    while (expected < num_items)
+    {
+        const size_t consumed = ring.consume([&](int &value)
+                                             { EXPECT_EQ(value, expected++); },
+                                             16);
+        if (consumed == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SPSCRingTest, ConcurrentProducerConsumer)
+{
+    // A ring much smaller than the run, so both sides keep hitting the
+    // full and empty edges
+    const int num_items = 100000;
+    SPSCRing<int, 64> ring;
+
+    std::thread producer([&]()
+                         {
+        for (int i = 0; i < num_items; ++i) {
+            while (!ring.try_push(i)) {
+                std::this_thread::yield();
+            }
+        } });
+
+    int expected = 0;
+    int value = 0;
+    while (expected < num_items)
+    {
+        if (ring.try_pop(value))
+        {
+            EXPECT_EQ(value, expected);
+            ++expected;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
+
 // Test fixture for MPMC Queue
 class MPMCQueueTest : public ::testing::Test
 {
@@ -413,4 +605,229 @@ TEST_F(MPMCQueueTest, Capacity)
 {
     EXPECT_EQ(int_queue.capacity(), 1024);
     EXPECT_EQ(string_queue.capacity(), 256);
-}
\ No newline at end of file
+}
+
+TEST_F(MPMCQueueTest, BatchOperations)
+{
+    EXPECT_TRUE(string_queue.emplace(3, 'x'));
+    auto first = string_queue.try_dequeue();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(*first, "xxx");
+
+    // A batch larger than the free space pushes what fits
+    std::vector<int> items(int_queue.capacity() + 10);
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        items[i] = static_cast<int>(i);
+    }
+    EXPECT_EQ(int_queue.try_push_n(items), int_queue.capacity());
+    EXPECT_EQ(int_queue.try_push_n(items), 0);
+
+    std::vector<int> out(100);
+    ASSERT_EQ(int_queue.pop_n(out.data(), out.size()), out.size());
+    EXPECT_EQ(out.front(), 0);
+    EXPECT_EQ(out.back(), 99);
+
+    int expected = 100;
+    EXPECT_EQ(int_queue.consume([&](int &value)
+                                { EXPECT_EQ(value, expected++); }),
+              int_queue.capacity() - 100);
+    EXPECT_TRUE(int_queue.empty());
+}
+
+TEST_F(MPMCQueueTest, PopWaitSleepsUntilPush)
+{
+    std::optional<int> result;
+    std::thread consumer([&]()
+                         { result = int_queue.pop_wait(std::chrono::seconds(5)); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(int_queue.try_enqueue(42));
+    consumer.join();
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 42);
+}
+
+TEST_F(MPMCQueueTest, PushWaitSleepsUntilPop)
+{
+    for (size_t i = 0; i < int_queue.capacity(); ++i)
+    {
+        ASSERT_TRUE(int_queue.try_enqueue(static_cast<int>(i)));
+    }
+
+    bool pushed = false;
+    std::thread producer([&]()
+                         { pushed = int_queue.push_wait(-1, std::chrono::seconds(5)); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto first = int_queue.try_dequeue();
+    producer.join();
+
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(*first, 0);
+    EXPECT_TRUE(pushed);
+    EXPECT_FALSE(int_queue.try_enqueue(0)); // Full again
+}
+
+TEST_F(MPMCQueueTest, WaitsGiveUpAtTimeout)
+{
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(int_queue.pop_wait(std::chrono::milliseconds(5)).has_value());
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(5));
+
+    for (size_t i = 0; i < int_queue.capacity(); ++i)
+    {
+        ASSERT_TRUE(int_queue.try_enqueue(static_cast<int>(i)));
+    }
+    start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(int_queue.push_wait(-1, std::chrono::milliseconds(5)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(5));
+}
+
+TEST(MPMCQueueBlockingTest, BlockedProducersAndConsumersAllFinish)
+{
+    // A tiny queue so both sides spend most of the run asleep
+    MPMCQueue<int, 16> queue;
+    const int num_producers = 4;
+    const int num_consumers = 4;
+    const int items_per_producer = 5000;
+    const int items_per_consumer = num_producers * items_per_producer / num_consumers;
+    std::atomic<long long> sum{0};
+    std::atomic<int> timeouts{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; ++p)
+    {
+        threads.emplace_back([&, p]()
+                             {
+            for (int i = 0; i < items_per_producer; ++i) {
+                if (!queue.push_wait(p * items_per_producer + i, std::chrono::seconds(5))) {
+                    timeouts++;
+                }
+            } });
+    }
+    for (int c = 0; c < num_consumers; ++c)
+    {
+        threads.emplace_back([&]()
+                             {
+            long long local = 0;
+            for (int i = 0; i < items_per_consumer; ++i) {
+                auto value = queue.pop_wait(std::chrono::seconds(5));
+                if (!value) {
+                    timeouts++;
+                    continue;
+                }
+                local += *value;
+            }
+            sum += local; });
+    }
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    const long long total = num_producers * items_per_producer;
+    EXPECT_EQ(timeouts.load(), 0);
+    EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(MPMCQueueTest, ConcurrentBatches)
+{
+    const int num_producers = 4;
+    const int num_consumers = 4;
+    const int items_per_producer = 20000;
+    std::atomic<int> consumed{0};
+    std::mutex seen_mutex;
+    std::set<int> seen;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; ++p)
+    {
+        threads.emplace_back([&, p]()
+                             {
+            std::vector<int> batch(32);
+            int next = 0;
+            while (next < items_per_producer) {
+                const int count = std::min<int>(batch.size(), items_per_producer - next);
+                for (int i = 0; i < count; ++i) {
+                    batch[i] = p * items_per_producer + next + i;
+                }
+                size_t pushed = 0;
+                while (pushed < static_cast<size_t>(count)) {
+                    pushed += int_queue.try_push_n(std::span<const int>(batch).subspan(pushed, count - pushed));
+                    std::this_thread::yield();
+                }
+                next += count;
+            } });
+    }
+    for (int c = 0; c < num_consumers; ++c)
+    {
+        threads.emplace_back([&]()
+                             {
+            std::vector<int> local;
+            while (consumed.load() < num_producers * items_per_producer) {
+                const size_t count = int_queue.consume([&](int &value)
+                                                       { local.push_back(value); },
+                                                       16);
+                consumed += static_cast<int>(count);
+                if (count == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            std::lock_guard<std::mutex> lock(seen_mutex);
+            for (int value : local) {
+                EXPECT_TRUE(seen.insert(value).second); // No duplicates
+            } });
+    }
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    EXPECT_EQ(seen.size(), static_cast<size_t>(num_producers * items_per_producer));
+}
+// Idle waiter tests
+
+TEST(IdleWaiterTest, ParkedConsumerWakesOnNotify)
+{
+    IdleWaiter waiter(WaitStrategy::SPIN_PARK);
+    SPSCQueue<int> queue;
+    std::atomic<bool> received{false};
+
+    std::thread consumer([&]
+                         {
+        for (;;)
+        {
+            if (queue.dequeue())
+            {
+                received = true;
+                return;
+            }
+            // A park far longer than the test: only notify() can end it in time
+            waiter.idle([&] { return !queue.empty(); }, std::chrono::seconds(30));
+        } });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Let it spin out and park
+    const auto start = std::chrono::steady_clock::now();
+    queue.enqueue(1);
+    waiter.notify();
+    consumer.join();
+
+    EXPECT_TRUE(received);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(IdleWaiterTest, ParkEndsAtTimeout)
+{
+    IdleWaiter waiter(WaitStrategy::SPIN_PARK);
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 2100; ++i) // Past any spin phase into parks
+    {
+        waiter.idle([] { return false; }, std::chrono::microseconds(100));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}